@@ -58,14 +58,13 @@ void* Allocator::Allocate() {
 		FillFreePage(pNewPage);
 #endif
 
-		if (m_pageList) {
-			pNewPage->pNext = m_pageList;
-		}
+		pNewPage->pNext = m_pageList;
 
 		m_pageList = pNewPage;
 
 		BlockHeader* pBlock = pNewPage->Blocks();
-		for (uint32_t i = 0; i < m_blockPerPage; i++) {
+		// link all blocks but the last, which terminates the free list
+		for (uint32_t i = 0; i < m_blockPerPage - 1; i++) {
 			pBlock->pNext = NextBlock(pBlock);
 			pBlock = NextBlock(pBlock);
 		}
@@ -1,11 +1,14 @@
-#include <iostream>
+#include <string.h>
 #include "BaseApplication.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
 
 using namespace My;
 
 bool My::BaseApplication::m_bQuit = false;
 
-My::BaseApplication::BaseApplication(GfxConfiguration& cfg) : m_Config(cfg)
+My::BaseApplication::BaseApplication(GfxConfiguration& cfg)
+	: m_Config(cfg), m_nArgC(0), m_ppArgV(nullptr)
 {
 
 }
@@ -13,7 +16,11 @@ My::BaseApplication::BaseApplication(GfxConfiguration& cfg) : m_Config(cfg)
 int My::BaseApplication::Initialize()
 {
 	m_bQuit = false;
-	std::cout << m_Config;
+	LOG_INFO("App Name:%s", m_Config.appName);
+	LOG_INFO("GfxConfiguration: R:%u G:%u B:%u A:%u D:%u S:%u M:%u W:%u H:%u",
+		m_Config.redBits, m_Config.greenBits, m_Config.blueBits, m_Config.alphaBits,
+		m_Config.depthBits, m_Config.stencilBits, m_Config.msaaSamples,
+		m_Config.screenWidth, m_Config.screenHeight);
 	return 0;
 }
 
@@ -24,11 +31,33 @@ void My::BaseApplication::Finalize()
 
 void My::BaseApplication::Tick()
 {
+	PROFILE_SCOPE("BaseApplication::Tick");
 
 }
 
 bool My::BaseApplication::IsQuit()
 {
-	std::cout << m_Config;
-	return 0;
+	return m_bQuit;
+}
+
+void My::BaseApplication::SetCommandLineParameters(int argc, char** argv)
+{
+	m_nArgC = argc;
+	m_ppArgV = argv;
+}
+
+bool My::BaseApplication::HasCommandLineOption(const char* option) const
+{
+	for (int i = 1; i < m_nArgC; i++) {
+		if (strcmp(m_ppArgV[i], option) == 0) return true;
+	}
+	return false;
+}
+
+const char* My::BaseApplication::GetCommandLineOption(const char* option) const
+{
+	for (int i = 1; i + 1 < m_nArgC; i++) {
+		if (strcmp(m_ppArgV[i], option) == 0) return m_ppArgV[i + 1];
+	}
+	return nullptr;
 }
\ No newline at end of file
@@ -14,13 +14,23 @@ namespace My
 		virtual void Tick();
 		virtual bool IsQuit();
 
+		virtual void SetCommandLineParameters(int argc, char** argv);
+
 		inline GfxConfiguration& GetConfiguration() { return m_Config; };
 
+	protected:
+		/// true if 'option' was given on the command line
+		bool HasCommandLineOption(const char* option) const;
+		/// argument following 'option', nullptr if absent
+		const char* GetCommandLineOption(const char* option) const;
+
 	protected:
 		static bool m_bQuit;
 		GfxConfiguration m_Config;
+		int m_nArgC;
+		char** m_ppArgV;
 
 	private:
-		BaseApplication() {};
+		BaseApplication() : m_nArgC(0), m_ppArgV(nullptr) {};
 	};
 }
@@ -0,0 +1,174 @@
+#include "EventBus.hpp"
+#include "Profiler.hpp"
+
+#ifndef ALIGN
+#define ALIGN(x, a) (((x) + ((a) - 1)) & ~((a) - 1))
+#endif
+
+using namespace My;
+
+namespace My {
+	// payloads are aligned like malloc would align them
+	static const size_t kEventAlignment = 16;
+	static const size_t kHeaderSize = ALIGN(sizeof(EventHeader), kEventAlignment);
+
+	static std::atomic<uint32_t> s_nEventTypeCount(0);
+}
+
+My::EventBus::EventBus(size_t arenaSize)
+	: m_nCurrent(0), m_nDropped(0), m_nArenaSize(arenaSize)
+{
+	for (Arena& arena : m_Arenas) {
+		arena.pMemory = nullptr;
+		arena.offset.store(0);
+		arena.pHead.store(nullptr);
+		arena.writers.store(0);
+	}
+}
+
+My::EventBus::~EventBus()
+{
+	Finalize();
+}
+
+int My::EventBus::Initialize()
+{
+	for (Arena& arena : m_Arenas) {
+		if (!arena.pMemory) {
+			arena.pMemory = new uint8_t[m_nArenaSize];
+		}
+		arena.offset.store(0);
+		arena.pHead.store(nullptr);
+		arena.writers.store(0);
+	}
+
+	m_nCurrent.store(0);
+	m_nDropped.store(0);
+
+	return 0;
+}
+
+void My::EventBus::Finalize()
+{
+	for (Arena& arena : m_Arenas) {
+		delete[] arena.pMemory;
+		arena.pMemory = nullptr;
+		arena.pHead.store(nullptr);
+	}
+
+	for (std::vector<Subscriber>& subscribers : m_Subscribers) {
+		subscribers.clear();
+	}
+}
+
+void My::EventBus::Tick()
+{
+	Dispatch();
+}
+
+uint32_t My::EventBus::NextTypeId()
+{
+	return s_nEventTypeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* My::EventBus::Allocate(uint32_t type, size_t size)
+{
+	if (type >= kMaxEventTypes) {
+		m_nDropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	size_t total = kHeaderSize + ALIGN(size, kEventAlignment);
+
+	// register as a writer before touching the arena, then make sure the
+	// dispatcher did not retire it in between; both sides use seq_cst so
+	// at least one of them sees the other
+	uint32_t index;
+	for (;;) {
+		index = m_nCurrent.load();
+		m_Arenas[index].writers.fetch_add(1);
+		if (m_nCurrent.load() == index)
+			break;
+		m_Arenas[index].writers.fetch_sub(1);
+	}
+
+	Arena& arena = m_Arenas[index];
+	size_t offset = arena.offset.fetch_add(total, std::memory_order_relaxed);
+	if (!arena.pMemory || offset + total > m_nArenaSize) {
+		arena.writers.fetch_sub(1, std::memory_order_release);
+		m_nDropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	EventHeader* pHeader = reinterpret_cast<EventHeader*>(arena.pMemory + offset);
+	pHeader->type = type;
+	pHeader->size = static_cast<uint32_t>(size);
+	pHeader->arena = index;
+
+	return reinterpret_cast<uint8_t*>(pHeader) + kHeaderSize;
+}
+
+void My::EventBus::Publish(void* pPayload)
+{
+	EventHeader* pHeader = reinterpret_cast<EventHeader*>(static_cast<uint8_t*>(pPayload) - kHeaderSize);
+	Arena& arena = m_Arenas[pHeader->arena];
+
+	EventHeader* pHead = arena.pHead.load(std::memory_order_relaxed);
+	do {
+		pHeader->pNext = pHead;
+	} while (!arena.pHead.compare_exchange_weak(pHead, pHeader,
+		std::memory_order_release, std::memory_order_relaxed));
+
+	arena.writers.fetch_sub(1, std::memory_order_release);
+}
+
+void My::EventBus::Dispatch()
+{
+	PROFILE_SCOPE("EventBus::Dispatch");
+
+	uint32_t retired = m_nCurrent.load();
+	Arena& arena = m_Arenas[retired];
+	Arena& next = m_Arenas[retired ^ 1];
+
+	// the other arena was drained by the previous dispatch
+	next.offset.store(0, std::memory_order_relaxed);
+	next.pHead.store(nullptr, std::memory_order_relaxed);
+	m_nCurrent.store(retired ^ 1);
+
+	// producers that already reserved space finish within a few instructions
+	while (arena.writers.load() != 0) {
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+
+	// the list is LIFO, reverse it to deliver in posting order
+	EventHeader* pEvent = arena.pHead.exchange(nullptr, std::memory_order_acquire);
+	EventHeader* pOrdered = nullptr;
+	while (pEvent) {
+		EventHeader* pNext = pEvent->pNext;
+		pEvent->pNext = pOrdered;
+		pOrdered = pEvent;
+		pEvent = pNext;
+	}
+
+	for (pEvent = pOrdered; pEvent; pEvent = pEvent->pNext) {
+		const std::vector<Subscriber>& subscribers = m_Subscribers[pEvent->type];
+		const void* pPayload = reinterpret_cast<const uint8_t*>(pEvent) + kHeaderSize;
+		for (const Subscriber& s : subscribers) {
+			s.invoke(s.handler, pPayload, s.pUserData);
+		}
+	}
+}
+
+void My::EventBus::RemoveSubscriber(uint32_t type, GenericHandler handler, void* pUserData)
+{
+	if (type >= kMaxEventTypes)
+		return;
+
+	std::vector<Subscriber>& subscribers = m_Subscribers[type];
+	for (size_t i = 0; i < subscribers.size(); i++) {
+		if (subscribers[i].handler == handler && subscribers[i].pUserData == pUserData) {
+			subscribers.erase(subscribers.begin() + i);
+			return;
+		}
+	}
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "IRuntimeModule.hpp"
+
+namespace My
+{
+	struct EventHeader
+	{
+		EventHeader* pNext;
+		uint32_t type;
+		uint32_t size;
+		uint32_t arena;
+	};
+
+	/// Frame-scoped publish/subscribe between modules.
+	///
+	/// Post() may be called from any thread and never takes a lock: the
+	/// event is copied into the current frame arena with an atomic bump
+	/// allocation and pushed onto that arena's intrusive list with a CAS.
+	/// Dispatch() (run from Tick() at the start of every frame) swaps the
+	/// arenas and delivers everything posted since the previous dispatch,
+	/// in posting order per producer, to the subscribers of each event's
+	/// own type only. Events posted while dispatching arrive next frame.
+	///
+	/// Subscribe()/Unsubscribe() belong to the main thread and must not be
+	/// called from inside a handler.
+	class EventBus : implements IRuntimeModule
+	{
+	public:
+		static const uint32_t kMaxEventTypes = 256;
+		static const size_t kDefaultArenaSize = 1 << 20;
+
+		template<typename T>
+		using Handler = void (*)(const T& event, void* pUserData);
+
+		EventBus(size_t arenaSize = kDefaultArenaSize);
+		virtual ~EventBus();
+
+		virtual int Initialize();
+		virtual void Finalize();
+		virtual void Tick();
+
+		/// Delivers every pending event. Main thread only.
+		void Dispatch();
+
+		/// Copies 'event' into the frame arena. Returns false (and drops the
+		/// event) when the arena is exhausted for this frame.
+		template<typename T>
+		bool Post(const T& event)
+		{
+			static_assert(std::is_trivially_destructible<T>::value,
+				"events live in frame memory and are never destroyed");
+
+			void* p = Allocate(TypeId<T>(), sizeof(T));
+			if (!p)
+				return false;
+
+			new (p) T(event);
+			Publish(p);
+			return true;
+		}
+
+		template<typename T>
+		void Subscribe(Handler<T> handler, void* pUserData = nullptr)
+		{
+			Subscriber s;
+			s.invoke = &Invoke<T>;
+			s.handler = reinterpret_cast<GenericHandler>(handler);
+			s.pUserData = pUserData;
+
+			uint32_t type = TypeId<T>();
+			if (type < kMaxEventTypes)
+				m_Subscribers[type].push_back(s);
+		}
+
+		template<typename T>
+		void Unsubscribe(Handler<T> handler, void* pUserData = nullptr)
+		{
+			RemoveSubscriber(TypeId<T>(), reinterpret_cast<GenericHandler>(handler), pUserData);
+		}
+
+		/// Small dense id per event type, assigned on first use.
+		template<typename T>
+		static uint32_t TypeId()
+		{
+			static const uint32_t id = NextTypeId();
+			return id;
+		}
+
+		inline uint64_t GetDroppedCount() const { return m_nDropped.load(std::memory_order_relaxed); };
+
+	private:
+		typedef void (*GenericHandler)();
+
+		struct Subscriber
+		{
+			void (*invoke)(GenericHandler handler, const void* pEvent, void* pUserData);
+			GenericHandler handler;
+			void* pUserData;
+		};
+
+		struct Arena
+		{
+			uint8_t* pMemory;
+			std::atomic<size_t> offset;
+			std::atomic<EventHeader*> pHead;
+			std::atomic<uint32_t> writers;   ///< producers between Allocate and Publish
+			uint8_t padding[64];
+		};
+
+		template<typename T>
+		static void Invoke(GenericHandler handler, const void* pEvent, void* pUserData)
+		{
+			reinterpret_cast<Handler<T>>(handler)(*static_cast<const T*>(pEvent), pUserData);
+		}
+
+		static uint32_t NextTypeId();
+
+		void* Allocate(uint32_t type, size_t size);
+		void Publish(void* pPayload);
+		void RemoveSubscriber(uint32_t type, GenericHandler handler, void* pUserData);
+
+	private:
+		Arena m_Arenas[2];
+		std::atomic<uint32_t> m_nCurrent;
+		std::atomic<uint64_t> m_nDropped;
+		size_t m_nArenaSize;
+
+		std::vector<Subscriber> m_Subscribers[kMaxEventTypes];
+	};
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cstring>
+
+#include "FrameStatistics.hpp"
+
+using namespace My;
+
+namespace My {
+	static double ToMilliseconds(uint64_t ns)
+	{
+		return ns / 1000000.0;
+	}
+
+	// nearest-rank percentile over an already sorted sample
+	static uint64_t Percentile(const std::vector<uint64_t>& sorted, double p)
+	{
+		size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.5);
+		if (rank > 0) --rank;
+		return sorted[std::min(rank, sorted.size() - 1)];
+	}
+}
+
+void My::FrameStatistics::Reset(size_t expectedFrames)
+{
+	m_FrameTimes.clear();
+	m_FrameTimes.reserve(expectedFrames);
+	m_Modules.clear();
+}
+
+void My::FrameStatistics::AddFrame(const ProfileFrame& frame)
+{
+	m_FrameTimes.push_back(frame.end - frame.begin);
+
+	for (const ProfileNode& node : frame.nodes) {
+		if (node.parent < 0)
+			continue;
+
+		const ProfileNode& parent = frame.nodes[node.parent];
+		if (parent.parent >= 0 || strcmp(parent.name, m_RootName) != 0)
+			continue;
+
+		ModuleTotal* pModule = nullptr;
+		for (ModuleTotal& m : m_Modules) {
+			if (m.name == node.name || strcmp(m.name, node.name) == 0) {
+				pModule = &m;
+				break;
+			}
+		}
+
+		if (!pModule) {
+			m_Modules.push_back({ node.name, 0, 0, 0 });
+			pModule = &m_Modules.back();
+		}
+
+		pModule->totalTime += node.inclusiveTime;
+		pModule->callCount += node.callCount;
+		pModule->maxTime = std::max(pModule->maxTime, node.inclusiveTime);
+	}
+}
+
+void My::FrameStatistics::WriteJson(FILE* fp) const
+{
+	size_t frames = m_FrameTimes.size();
+
+	fprintf(fp, "{\n  \"frames\": %zu,\n", frames);
+
+	if (frames) {
+		std::vector<uint64_t> sorted(m_FrameTimes);
+		std::sort(sorted.begin(), sorted.end());
+
+		uint64_t total = 0;
+		for (uint64_t t : sorted) total += t;
+
+		fprintf(fp, "  \"frame_time_ms\": {\"min\": %.6f, \"mean\": %.6f, \"p50\": %.6f, "
+			"\"p95\": %.6f, \"p99\": %.6f, \"max\": %.6f},\n",
+			ToMilliseconds(sorted.front()),
+			ToMilliseconds(total) / frames,
+			ToMilliseconds(Percentile(sorted, 50.0)),
+			ToMilliseconds(Percentile(sorted, 95.0)),
+			ToMilliseconds(Percentile(sorted, 99.0)),
+			ToMilliseconds(sorted.back()));
+	}
+
+	fprintf(fp, "  \"modules\": [");
+	for (size_t i = 0; i < m_Modules.size(); i++) {
+		const ModuleTotal& m = m_Modules[i];
+		fprintf(fp, "%s\n    {\"name\": \"%s\", \"mean_ms\": %.6f, \"max_ms\": %.6f, \"calls_per_frame\": %.3f}",
+			i ? "," : "",
+			m.name,
+			ToMilliseconds(m.totalTime) / frames,
+			ToMilliseconds(m.maxTime),
+			static_cast<double>(m.callCount) / frames);
+	}
+	fprintf(fp, "%s]\n}\n", m_Modules.empty() ? "" : "\n  ");
+}
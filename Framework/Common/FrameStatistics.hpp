@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Profiler.hpp"
+
+namespace My
+{
+	/// Accumulates frame times and per-module times from profiler frames
+	/// and reports them as a JSON document.
+	class FrameStatistics
+	{
+	public:
+		FrameStatistics() : m_RootName("Frame") {};
+
+		/// Name of the scope whose direct children count as modules.
+		void SetRootScope(const char* name) { m_RootName = name; };
+
+		void Reset(size_t expectedFrames);
+		void AddFrame(const ProfileFrame& frame);
+
+		inline size_t GetFrameCount() const { return m_FrameTimes.size(); };
+
+		/// Writes min/mean/p50/p95/p99/max of the frame time and the mean
+		/// time per frame of every module, all in milliseconds.
+		void WriteJson(FILE* fp) const;
+
+	private:
+		struct ModuleTotal
+		{
+			const char* name;
+			uint64_t totalTime;
+			uint64_t callCount;
+			uint64_t maxTime;
+		};
+
+		const char* m_RootName;
+		std::vector<uint64_t> m_FrameTimes;
+		std::vector<ModuleTotal> m_Modules;
+	};
+}
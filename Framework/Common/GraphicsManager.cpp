@@ -1,4 +1,5 @@
 #include "GraphicsManager.hpp"
+#include "Profiler.hpp"
 
 using namespace My;
 
@@ -12,5 +13,5 @@ void My::GraphicsManager::Finalize() {
 }
 
 void My::GraphicsManager::Tick() {
-    
+    PROFILE_SCOPE("GraphicsManager::Tick");
 }
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <chrono>
+
+#include "Logger.hpp"
+#include "Profiler.hpp"
+
+using namespace My;
+
+namespace My {
+	// how long the flush thread sleeps when every ring is empty
+	static const std::chrono::milliseconds kIdleInterval(2);
+	static const size_t kMaxLineLength = 1024;
+
+	static const char* const kLevelNames[] = { "DEBUG", "INFO ", "WARN ", "ERROR" };
+
+	std::atomic<LogBuffer*> Logger::s_pBufferList(nullptr);
+	std::atomic<uint32_t>   Logger::s_nThreadCount(0);
+	std::atomic<int>        Logger::s_nLevel(kLogLevelDebug);
+
+	static thread_local LogBuffer* t_pLogBuffer = nullptr;
+}
+
+void My::ConsoleLogSink::Write(LogLevel level, const char* line, size_t length)
+{
+	fwrite(line, 1, length, level >= m_nStderrLevel ? stderr : stdout);
+}
+
+void My::ConsoleLogSink::Flush()
+{
+	fflush(stdout);
+	fflush(stderr);
+}
+
+My::FileLogSink::FileLogSink(const char* path)
+{
+	m_pFile = fopen(path, "w");
+}
+
+My::FileLogSink::~FileLogSink()
+{
+	if (m_pFile) fclose(m_pFile);
+}
+
+void My::FileLogSink::Write(LogLevel level, const char* line, size_t length)
+{
+	if (m_pFile) fwrite(line, 1, length, m_pFile);
+}
+
+void My::FileLogSink::Flush()
+{
+	if (m_pFile) fflush(m_pFile);
+}
+
+size_t My::LogBuffer::Drain(std::vector<LogRecord>& out)
+{
+	uint32_t tail = m_tail.load(std::memory_order_relaxed);
+	uint32_t head = m_head.load(std::memory_order_acquire);
+
+	for (uint32_t i = tail; i != head; i++) {
+		out.push_back(m_records[i & (kCapacity - 1)]);
+	}
+
+	m_tail.store(head, std::memory_order_release);
+	return head - tail;
+}
+
+My::Logger::Logger(ThreadSetupFunc pfnThreadSetup)
+	: m_pDefaultSink(nullptr), m_pfnThreadSetup(pfnThreadSetup), m_bRunning(false), m_nTimeBase(0)
+{
+}
+
+My::Logger::~Logger()
+{
+	Finalize();
+	delete m_pDefaultSink;
+}
+
+int My::Logger::Initialize()
+{
+	if (m_bRunning.load())
+		return 0;
+
+	if (m_Sinks.empty()) {
+		m_pDefaultSink = new ConsoleLogSink;
+		m_Sinks.push_back(m_pDefaultSink);
+	}
+
+	m_nTimeBase = Now();
+	m_bRunning.store(true);
+	m_Thread = std::thread(&Logger::ThreadMain, this);
+
+	return 0;
+}
+
+void My::Logger::Finalize()
+{
+	if (!m_bRunning.exchange(false))
+		return;
+
+	if (m_Thread.joinable())
+		m_Thread.join();
+}
+
+void My::Logger::Tick()
+{
+}
+
+uint64_t My::Logger::Now()
+{
+	return Profiler::Now();
+}
+
+LogBuffer* My::Logger::GetThreadBuffer()
+{
+	LogBuffer* pBuffer = t_pLogBuffer;
+	if (!pBuffer) {
+		pBuffer = new LogBuffer(s_nThreadCount.fetch_add(1, std::memory_order_relaxed));
+		LogBuffer* pHead = s_pBufferList.load(std::memory_order_relaxed);
+		do {
+			pBuffer->m_pNext = pHead;
+		} while (!s_pBufferList.compare_exchange_weak(pHead, pBuffer,
+			std::memory_order_release, std::memory_order_relaxed));
+		t_pLogBuffer = pBuffer;
+	}
+
+	return pBuffer;
+}
+
+void My::Logger::ThreadMain()
+{
+	if (m_pfnThreadSetup)
+		m_pfnThreadSetup();
+
+	std::vector<LogRecord> batch;
+	batch.reserve(LogBuffer::kCapacity);
+
+	while (m_bRunning.load(std::memory_order_acquire)) {
+		if (Flush(batch) == 0) {
+			std::this_thread::sleep_for(kIdleInterval);
+		}
+	}
+
+	// pick up whatever was written while we were shutting down
+	Flush(batch);
+}
+
+size_t My::Logger::Flush(std::vector<LogRecord>& batch)
+{
+	batch.clear();
+	for (LogBuffer* p = s_pBufferList.load(std::memory_order_acquire); p; p = p->m_pNext) {
+		p->Drain(batch);
+	}
+
+	if (batch.empty())
+		return 0;
+
+	// interleave the per-thread streams in time order
+	std::stable_sort(batch.begin(), batch.end(), [](const LogRecord& a, const LogRecord& b) {
+		return a.timestamp < b.timestamp;
+	});
+
+	char line[kMaxLineLength];
+	for (const LogRecord& record : batch) {
+		size_t length = Format(record, m_nTimeBase, line, sizeof(line));
+		for (ILogSink* pSink : m_Sinks) {
+			pSink->Write(static_cast<LogLevel>(record.level), line, length);
+		}
+	}
+
+	for (ILogSink* pSink : m_Sinks) {
+		pSink->Flush();
+	}
+
+	return batch.size();
+}
+
+size_t My::Logger::Format(const LogRecord& record, uint64_t timeBase, char* line, size_t size)
+{
+	int64_t elapsed = static_cast<int64_t>(record.timestamp - timeBase);
+	int written = snprintf(line, size, "[%12.6f] [%s] [T%u] ",
+		elapsed / 1000000000.0, kLevelNames[record.level], record.threadId);
+	size_t pos = written > 0 ? std::min(static_cast<size_t>(written), size - 1) : 0;
+
+	// walk the printf format ourselves, handing each conversion one
+	// argument at a time, since the arguments are no longer a va_list
+	uint32_t arg = 0;
+	const char* f = record.format;
+	while (*f && pos + 1 < size) {
+		if (*f != '%') {
+			line[pos++] = *f++;
+			continue;
+		}
+
+		if (f[1] == '%') {
+			line[pos++] = '%';
+			f += 2;
+			continue;
+		}
+
+		char spec[32];
+		size_t n = 0;
+		spec[n++] = *f++;
+		while (*f && strchr("-+ #0123456789.*", *f) && n < sizeof(spec) - 4) {
+			if (*f != '*') {
+				spec[n++] = *f++;
+				continue;
+			}
+
+			// width or precision given as an argument: take it from the
+			// next argument and write it into the spec as digits
+			f++;
+			long long value = 0;
+			if (arg < record.argCount) {
+				const LogArgument& star = record.args[arg];
+				uint8_t starType = record.argTypes[arg++];
+				value = starType == kLogArgumentDouble ? static_cast<long long>(star.d) : star.i;
+			}
+			// nothing wider than a line can show anyway
+			value = std::max(std::min(value, static_cast<long long>(kMaxLineLength)),
+				-static_cast<long long>(kMaxLineLength));
+			if (value < 0 && spec[n - 1] == '.') {
+				// a negative precision counts as none
+				n--;
+				continue;
+			}
+			char digits[24];
+			int length = snprintf(digits, sizeof(digits), "%lld", value);
+			if (length > 0 && n + length < sizeof(spec) - 4) {
+				memcpy(spec + n, digits, length);
+				n += length;
+			}
+		}
+		// integer length modifiers are replaced by 'll' below
+		while (*f && strchr("hljztL", *f)) {
+			f++;
+		}
+
+		char conversion = *f;
+		if (!conversion)
+			break;
+		f++;
+
+		if (arg >= record.argCount) {
+			continue;
+		}
+
+		const LogArgument& value = record.args[arg];
+		uint8_t type = record.argTypes[arg++];
+		size_t room = size - pos;
+
+		switch (conversion) {
+		case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+			if (conversion != 'c') {
+				spec[n++] = 'l';
+				spec[n++] = 'l';
+			}
+			spec[n++] = conversion;
+			spec[n] = '\0';
+			if (conversion == 'c')
+				written = snprintf(line + pos, room, spec, static_cast<int>(value.i));
+			else if (type == kLogArgumentDouble)
+				written = snprintf(line + pos, room, spec, static_cast<long long>(value.d));
+			else
+				written = snprintf(line + pos, room, spec, static_cast<long long>(value.i));
+			break;
+		case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+			spec[n++] = conversion;
+			spec[n] = '\0';
+			if (type == kLogArgumentSigned)
+				written = snprintf(line + pos, room, spec, static_cast<double>(value.i));
+			else if (type == kLogArgumentUnsigned)
+				written = snprintf(line + pos, room, spec, static_cast<double>(value.u));
+			else
+				written = snprintf(line + pos, room, spec, value.d);
+			break;
+		case 's':
+			spec[n++] = 's';
+			spec[n] = '\0';
+			written = snprintf(line + pos, room, spec,
+				type == kLogArgumentString ? record.text + value.u : "(?)");
+			break;
+		case 'p':
+			spec[n++] = 'p';
+			spec[n] = '\0';
+			written = snprintf(line + pos, room, spec, value.p);
+			break;
+		default:
+			written = 0;
+			break;
+		}
+
+		if (written > 0) {
+			pos += std::min(static_cast<size_t>(written), room - 1);
+		}
+	}
+
+	if (pos + 1 >= size) pos = size - 2;
+	if (pos == 0 || line[pos - 1] != '\n') line[pos++] = '\n';
+	line[pos] = '\0';
+
+	return pos;
+}
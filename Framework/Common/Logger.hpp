@@ -0,0 +1,313 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "IRuntimeModule.hpp"
+
+namespace My
+{
+	typedef enum LogLevel {
+		kLogLevelDebug = 0,
+		kLogLevelInfo = 1,
+		kLogLevelWarning = 2,
+		kLogLevelError = 3,
+		kLogLevelNone = 4,
+	} LogLevel;
+
+	typedef enum LogArgumentType {
+		kLogArgumentSigned = 0,
+		kLogArgumentUnsigned,
+		kLogArgumentDouble,
+		kLogArgumentString,   ///< copied into LogRecord::text
+		kLogArgumentPointer,
+	} LogArgumentType;
+
+	union LogArgument
+	{
+		int64_t  i;
+		uint64_t u;
+		double   d;
+		const void* p;
+	};
+
+	/// Unformatted log entry. The format string is only referenced, so it
+	/// must have static storage; string arguments are copied into 'text'.
+	struct LogRecord
+	{
+		static const uint32_t kMaxArguments = 12;
+		static const uint32_t kTextSize = 120;
+
+		uint64_t timestamp;
+		const char* format;
+		uint32_t threadId;
+		uint8_t level;
+		uint8_t argCount;
+		uint8_t textUsed;
+		uint8_t argTypes[kMaxArguments];
+		LogArgument args[kMaxArguments];
+		char text[kTextSize];
+	};
+
+	/// Destination of formatted log lines, called from the logger thread only.
+	Interface ILogSink
+	{
+	public:
+		virtual ~ILogSink() {};
+		virtual void Write(LogLevel level, const char* line, size_t length) = 0;
+		virtual void Flush() = 0;
+	};
+
+	/// Levels from 'stderrLevel' up to stderr, the others to stdout; by
+	/// default Debug/Info to stdout, Warning/Error to stderr.
+	class ConsoleLogSink : implements ILogSink
+	{
+	public:
+		ConsoleLogSink(LogLevel stderrLevel = kLogLevelWarning) : m_nStderrLevel(stderrLevel) {};
+
+		virtual void Write(LogLevel level, const char* line, size_t length);
+		virtual void Flush();
+
+	private:
+		LogLevel m_nStderrLevel;
+	};
+
+	class FileLogSink : implements ILogSink
+	{
+	public:
+		FileLogSink(const char* path);
+		virtual ~FileLogSink();
+
+		inline bool IsOpen() const { return m_pFile != nullptr; };
+
+		virtual void Write(LogLevel level, const char* line, size_t length);
+		virtual void Flush();
+
+	private:
+		FILE* m_pFile;
+	};
+
+	/// Single-producer/single-consumer ring owned by one logging thread.
+	/// Full rings drop records rather than wait for the flush thread.
+	class LogBuffer
+	{
+	public:
+		static const uint32_t kCapacity = 1 << 11;
+
+		LogBuffer(uint32_t threadId)
+			: m_head(0), m_tail(0), m_dropped(0), m_threadId(threadId), m_pNext(nullptr) {};
+
+		inline LogRecord* Reserve()
+		{
+			uint32_t head = m_head.load(std::memory_order_relaxed);
+			if (head - m_tail.load(std::memory_order_acquire) >= kCapacity) {
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			LogRecord* pRecord = &m_records[head & (kCapacity - 1)];
+			pRecord->threadId = m_threadId;
+			return pRecord;
+		}
+
+		inline void Commit()
+		{
+			m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		/// Consumer side: append every pending record to out.
+		size_t Drain(std::vector<LogRecord>& out);
+
+		inline uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); };
+
+	private:
+		LogRecord m_records[kCapacity];
+		std::atomic<uint32_t> m_head;
+		uint8_t m_padding[60];
+		std::atomic<uint32_t> m_tail;
+		std::atomic<uint64_t> m_dropped;
+		uint32_t m_threadId;
+
+		LogBuffer* m_pNext;
+		friend class Logger;
+	};
+
+	class Logger : implements IRuntimeModule
+	{
+	public:
+		/// Runs first thing on the flush thread, for the platform layer to
+		/// name it or set its priority.
+		typedef void (*ThreadSetupFunc)();
+
+		Logger(ThreadSetupFunc pfnThreadSetup = nullptr);
+		virtual ~Logger();
+
+		/// Starts the flush thread. Records written before this are kept.
+		virtual int Initialize();
+		/// Flushes everything still queued, then stops the flush thread.
+		virtual void Finalize();
+		virtual void Tick();
+
+		/// Must be called before Initialize(). Without any sink the logger
+		/// writes to the console.
+		void AddSink(ILogSink* pSink) { m_Sinks.push_back(pSink); };
+		/// Runtime filter on top of the compile time MY_LOG_LEVEL.
+		void SetLevel(LogLevel level) { s_nLevel.store(level, std::memory_order_relaxed); };
+
+		template<typename... Arguments>
+		static void Write(LogLevel level, const char* format, const Arguments&... args)
+		{
+			static_assert(sizeof...(Arguments) <= LogRecord::kMaxArguments, "too many log arguments");
+
+			if (level < s_nLevel.load(std::memory_order_relaxed))
+				return;
+
+			LogBuffer* pBuffer = GetThreadBuffer();
+			LogRecord* pRecord = pBuffer->Reserve();
+			if (!pRecord)
+				return;
+
+			pRecord->timestamp = Now();
+			pRecord->format = format;
+			pRecord->level = static_cast<uint8_t>(level);
+			pRecord->argCount = 0;
+			pRecord->textUsed = 0;
+			Encode(*pRecord, args...);
+			pBuffer->Commit();
+		}
+
+		/// Expands a record into 'line', returns the length written.
+		static size_t Format(const LogRecord& record, uint64_t timeBase, char* line, size_t size);
+
+		static LogBuffer* GetThreadBuffer();
+
+	private:
+		static uint64_t Now();
+
+		static void Encode(LogRecord&) {}
+
+		template<typename T, typename... Rest>
+		static void Encode(LogRecord& record, const T& value, const Rest&... rest)
+		{
+			EncodeArgument(record, value);
+			Encode(record, rest...);
+		}
+
+		template<typename T>
+		static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+		EncodeArgument(LogRecord& record, T value)
+		{
+			record.argTypes[record.argCount] = kLogArgumentSigned;
+			record.args[record.argCount++].i = value;
+		}
+
+		template<typename T>
+		static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+		EncodeArgument(LogRecord& record, T value)
+		{
+			record.argTypes[record.argCount] = kLogArgumentUnsigned;
+			record.args[record.argCount++].u = value;
+		}
+
+		template<typename T>
+		static typename std::enable_if<std::is_enum<T>::value>::type
+		EncodeArgument(LogRecord& record, T value)
+		{
+			record.argTypes[record.argCount] = kLogArgumentSigned;
+			record.args[record.argCount++].i = static_cast<int64_t>(value);
+		}
+
+		template<typename T>
+		static typename std::enable_if<std::is_floating_point<T>::value>::type
+		EncodeArgument(LogRecord& record, T value)
+		{
+			record.argTypes[record.argCount] = kLogArgumentDouble;
+			record.args[record.argCount++].d = value;
+		}
+
+		template<typename T>
+		static void EncodeArgument(LogRecord& record, const T* value)
+		{
+			record.argTypes[record.argCount] = kLogArgumentPointer;
+			record.args[record.argCount++].p = value;
+		}
+
+		static void EncodeArgument(LogRecord& record, const char* value)
+		{
+			// copy, the caller's string may not outlive the record
+			if (!value) value = "(null)";
+			size_t room = LogRecord::kTextSize - record.textUsed;
+			size_t length = strlen(value);
+			if (room == 0) {
+				record.argTypes[record.argCount] = kLogArgumentString;
+				record.args[record.argCount++].u = LogRecord::kTextSize - 1;
+				return;
+			}
+			if (length >= room) length = room - 1;
+
+			memcpy(record.text + record.textUsed, value, length);
+			record.text[record.textUsed + length] = '\0';
+			record.argTypes[record.argCount] = kLogArgumentString;
+			record.args[record.argCount++].u = record.textUsed;
+			record.textUsed = static_cast<uint8_t>(record.textUsed + length + 1);
+		}
+
+		static void EncodeArgument(LogRecord& record, char* value)
+		{
+			EncodeArgument(record, static_cast<const char*>(value));
+		}
+
+		void ThreadMain();
+		size_t Flush(std::vector<LogRecord>& batch);
+
+	private:
+		static std::atomic<LogBuffer*> s_pBufferList;
+		static std::atomic<uint32_t> s_nThreadCount;
+		static std::atomic<int> s_nLevel;
+
+		std::vector<ILogSink*> m_Sinks;
+		ConsoleLogSink* m_pDefaultSink;
+		ThreadSetupFunc m_pfnThreadSetup;
+		std::thread m_Thread;
+		std::atomic<bool> m_bRunning;
+		uint64_t m_nTimeBase;
+	};
+}
+
+#ifndef MY_LOG_LEVEL
+#if defined(_DEBUG)
+#define MY_LOG_LEVEL 0
+#else
+#define MY_LOG_LEVEL 1
+#endif
+#endif
+
+// Levels below MY_LOG_LEVEL compile to nothing, arguments are not evaluated.
+#if MY_LOG_LEVEL <= 0
+#define LOG_DEBUG(...) My::Logger::Write(My::kLogLevelDebug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+#if MY_LOG_LEVEL <= 1
+#define LOG_INFO(...) My::Logger::Write(My::kLogLevelInfo, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if MY_LOG_LEVEL <= 2
+#define LOG_WARNING(...) My::Logger::Write(My::kLogLevelWarning, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) do {} while (0)
+#endif
+
+#if MY_LOG_LEVEL <= 3
+#define LOG_ERROR(...) My::Logger::Write(My::kLogLevelError, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#endif
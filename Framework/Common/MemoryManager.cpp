@@ -1,6 +1,7 @@
 #include <malloc.h>
 
 #include "MemoryManager.hpp"
+#include "Profiler.hpp"
 
 using namespace My;
 
@@ -58,6 +59,7 @@ void My::MemoryManager::Finalize() {
 }
 
 void My::MemoryManager::Tick() {
+	PROFILE_SCOPE("MemoryManager::Tick");
 
 }
 
@@ -82,4 +84,22 @@ void My::MemoryManager::Free(void* p, size_t size) {
 		pAlloc->Free(p);
 	else
 		free(p);
-}
\ No newline at end of file
+}
+
+void* My::MemoryManager::AllocateAligned(size_t size, size_t alignment) {
+	size_t total = size + alignment - 1 + sizeof(void*);
+	uint8_t* pRaw = reinterpret_cast<uint8_t*>(Allocate(total));
+	if (!pRaw)
+		return nullptr;
+
+	uintptr_t aligned = (reinterpret_cast<uintptr_t>(pRaw) + sizeof(void*) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	reinterpret_cast<void**>(aligned)[-1] = pRaw;
+	return reinterpret_cast<void*>(aligned);
+}
+
+void My::MemoryManager::FreeAligned(void* p, size_t size, size_t alignment) {
+	if (!p)
+		return;
+
+	Free(reinterpret_cast<void**>(p)[-1], size + alignment - 1 + sizeof(void*));
+}
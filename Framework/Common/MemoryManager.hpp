@@ -10,7 +10,7 @@ namespace My {
 	public:
 		template<typename T, typename... Arguments>
 		T* New(Arguments... parameters) {
-			return new (Allocator(sizeof(T))) T(parameters...);
+			return new (Allocate(sizeof(T))) T(parameters...);
 		}
 
 		template<typename T>
@@ -28,6 +28,13 @@ namespace My {
 		void* Allocate(size_t size);
 		void Free(void* p, size_t size);
 
+		/// Pool blocks are only 4-byte aligned; these over-allocate and
+		/// keep the original pointer just below the returned address.
+		/// 'alignment' must be a power of two, and FreeAligned must get the
+		/// same size and alignment as the allocation.
+		void* AllocateAligned(size_t size, size_t alignment);
+		void FreeAligned(void* p, size_t size, size_t alignment);
+
 	private:
 		static size_t* m_pBlockSizeLookup;
 		static Allocator* m_pAllocators;
@@ -1,4 +1,5 @@
 #pragma once
+#include <stdint.h>
 
 namespace My {
 	typedef enum IndexSize {
@@ -62,5 +63,10 @@ namespace My {
 	public:
 		uint32_t m_vertexStride; // in bytes
 		uint32_t m_reserved[3];
+		// object space bounds of the positions, filled in by UpdateMeshBounds()
+		// when the mesh is built or loaded
+		float    m_boundsMin[3];
+		float    m_boundsMax[3];
+		float    m_boundingSphere[4]; // center xyz, radius
 	};
 }
\ No newline at end of file
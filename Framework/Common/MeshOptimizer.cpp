@@ -0,0 +1,435 @@
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "MeshOptimizer.hpp"
+#include "geommath.hpp"
+
+using namespace My;
+
+namespace {
+	const uint32_t kMaxCacheSize = 64;
+	// valences above this share the last score
+	const uint32_t kMaxValence = 32;
+
+	// the constants of Forsyth's reference implementation
+	const float kCacheDecayPower = 1.5f;
+	const float kLastTriangleScore = 0.75f;
+	const float kValenceBoostScale = 2.0f;
+	const float kValenceBoostPower = 0.5f;
+
+	bool IsIndexedTriangleList(const SimpleMesh& mesh)
+	{
+		return mesh.m_primitiveType == kPrimitiveTypeTriList && mesh.m_indexBuffer && mesh.m_indexCount % 3 == 0
+			&& (mesh.m_indexType == kIndexSize16 || mesh.m_indexType == kIndexSize32);
+	}
+
+	template<typename Index>
+	VertexCacheStatistics AnalyzeFifo(const Index* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		// a vertex is cached while fewer than cacheSize misses followed the
+		// one that loaded it; 0 marks vertices never loaded
+		std::vector<uint32_t> loadedAt(vertexCount, 0);
+		uint32_t misses = 0, referenced = 0;
+		for (uint32_t i = 0; i < indexCount; i++) {
+			uint32_t v = indices[i];
+			if (!loadedAt[v])
+				referenced++;
+			if (!loadedAt[v] || misses - loadedAt[v] >= cacheSize) {
+				misses++;
+				loadedAt[v] = misses;
+			}
+		}
+
+		VertexCacheStatistics statistics;
+		statistics.misses = misses;
+		statistics.acmr = indexCount ? misses * 3.0f / indexCount : 0.0f;
+		statistics.atvr = referenced ? static_cast<float>(misses) / referenced : 0.0f;
+		return statistics;
+	}
+
+	template<typename Index>
+	void OptimizeForsyth(Index* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		const uint32_t triangleCount = indexCount / 3;
+		const std::vector<Index> input(indices, indices + indexCount);
+
+		float cacheScores[kMaxCacheSize];
+		for (uint32_t i = 0; i < cacheSize; i++) {
+			if (i < 3)
+				cacheScores[i] = kLastTriangleScore;
+			else
+				cacheScores[i] = powf(1.0f - static_cast<float>(i - 3) / (cacheSize - 3), kCacheDecayPower);
+		}
+		float valenceScores[kMaxValence + 1];
+		valenceScores[0] = 0.0f;
+		for (uint32_t i = 1; i <= kMaxValence; i++)
+			valenceScores[i] = kValenceBoostScale * powf(static_cast<float>(i), -kValenceBoostPower);
+
+		// triangles still to emit around every vertex, in one array; the
+		// first remaining[v] entries after offsets[v] are live
+		std::vector<uint32_t> remaining(vertexCount, 0);
+		for (uint32_t i = 0; i < indexCount; i++)
+			remaining[input[i]]++;
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			offsets[v + 1] = offsets[v] + remaining[v];
+		std::vector<uint32_t> adjacency(indexCount);
+		{
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for (uint32_t i = 0; i < indexCount; i++)
+				adjacency[fill[input[i]]++] = i / 3;
+		}
+
+		std::vector<int32_t> cachePosition(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		auto ScoreVertex = [&](uint32_t v) {
+			if (!remaining[v])
+				return -1.0f;
+			float score = cachePosition[v] >= 0 ? cacheScores[cachePosition[v]] : 0.0f;
+			return score + valenceScores[remaining[v] < kMaxValence ? remaining[v] : kMaxValence];
+		};
+		for (uint32_t v = 0; v < vertexCount; v++)
+			vertexScores[v] = ScoreVertex(v);
+
+		std::vector<float> triangleScores(triangleCount);
+		std::vector<bool> emitted(triangleCount, false);
+		int32_t best = -1;
+		for (uint32_t t = 0; t < triangleCount; t++) {
+			triangleScores[t] = vertexScores[input[t * 3]] + vertexScores[input[t * 3 + 1]] + vertexScores[input[t * 3 + 2]];
+			if (best < 0 || triangleScores[t] > triangleScores[best])
+				best = static_cast<int32_t>(t);
+		}
+
+		uint32_t cache[kMaxCacheSize + 3];
+		uint32_t cacheCount = 0;
+		uint32_t next = 0;    // fallback scan when the cache has nothing left
+		Index* out = indices;
+
+		for (uint32_t n = 0; n < triangleCount; n++) {
+			if (best < 0) {
+				while (emitted[next])
+					next++;
+				best = static_cast<int32_t>(next);
+			}
+
+			const uint32_t t = static_cast<uint32_t>(best);
+			emitted[t] = true;
+			uint32_t newCache[kMaxCacheSize + 3];
+			uint32_t newCount = 0;
+			for (uint32_t k = 0; k < 3; k++) {
+				uint32_t v = input[t * 3 + k];
+				*out++ = static_cast<Index>(v);
+
+				uint32_t* list = &adjacency[offsets[v]];
+				for (uint32_t j = 0; j < remaining[v]; j++) {
+					if (list[j] == t) {
+						list[j] = list[remaining[v] - 1];
+						remaining[v]--;
+						break;
+					}
+				}
+
+				bool present = false;
+				for (uint32_t j = 0; j < newCount; j++)
+					present = present || newCache[j] == v;
+				if (!present)
+					newCache[newCount++] = v;
+			}
+			const uint32_t triangleVertices = newCount;
+			for (uint32_t j = 0; j < cacheCount; j++) {
+				bool present = false;
+				for (uint32_t k = 0; k < triangleVertices; k++)
+					present = present || cache[j] == newCache[k];
+				if (!present)
+					newCache[newCount++] = cache[j];
+			}
+
+			// entries pushed past the end leave the cache but are rescored
+			for (uint32_t j = 0; j < newCount; j++) {
+				uint32_t v = newCache[j];
+				cachePosition[v] = j < cacheSize ? static_cast<int32_t>(j) : -1;
+				vertexScores[v] = ScoreVertex(v);
+			}
+
+			best = -1;
+			for (uint32_t j = 0; j < newCount; j++) {
+				uint32_t v = newCache[j];
+				const uint32_t* list = &adjacency[offsets[v]];
+				for (uint32_t k = 0; k < remaining[v]; k++) {
+					uint32_t u = list[k];
+					triangleScores[u] = vertexScores[input[u * 3]] + vertexScores[input[u * 3 + 1]] + vertexScores[input[u * 3 + 2]];
+					if (best < 0 || triangleScores[u] > triangleScores[best])
+						best = static_cast<int32_t>(u);
+				}
+			}
+
+			cacheCount = newCount < cacheSize ? newCount : cacheSize;
+			memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+		}
+	}
+
+	// the post-transform cache modelled by the fetch and overdraw passes
+	const uint32_t kFifoSize = 16;
+
+	const uint32_t kFetchLineSize = 64;
+	const uint32_t kFetchWays = 4;
+
+	/// FIFO post-transform cache, as in AnalyzeFifo, for passes that walk
+	/// the triangles one at a time. Reset() starts over with an empty cache.
+	class FifoCache
+	{
+	public:
+		explicit FifoCache(uint32_t vertexCount) : m_loadedAt(vertexCount, 0), m_nMisses(0) {}
+
+		/// True when v had to be shaded.
+		bool Access(uint32_t v) {
+			if (m_loadedAt[v] && m_nMisses - m_loadedAt[v] < kFifoSize)
+				return false;
+			m_loadedAt[v] = ++m_nMisses;
+			return true;
+		}
+
+		// advancing past the cache size evicts every entry without touching
+		// the whole array
+		void Reset() { m_nMisses += kFifoSize; }
+
+	private:
+		std::vector<uint32_t> m_loadedAt;
+		uint32_t m_nMisses;
+	};
+
+	template<typename Index>
+	void OptimizeOverdrawClusters(Index* indices, uint32_t indexCount, uint32_t vertexCount,
+		const uint8_t* vertices, uint32_t vertexStride, float threshold)
+	{
+		const uint32_t triangleCount = indexCount / 3;
+		const std::vector<Index> input(indices, indices + indexCount);
+		FifoCache cache(vertexCount);
+
+		std::vector<uint8_t> misses(triangleCount);
+		for (uint32_t t = 0; t < triangleCount; t++) {
+			misses[t] = static_cast<uint8_t>(cache.Access(input[t * 3]) + cache.Access(input[t * 3 + 1])
+				+ cache.Access(input[t * 3 + 2]));
+		}
+
+		// hard boundaries: triangles where the cache order restarted
+		std::vector<uint32_t> hard;
+		for (uint32_t t = 0; t < triangleCount; t++) {
+			if (t == 0 || misses[t] == 3)
+				hard.push_back(t);
+		}
+		hard.push_back(triangleCount);
+
+		// soft boundaries: cut a hard cluster as soon as the part since the
+		// last cut, replayed from an empty cache, is within the threshold of
+		// the whole cluster's ACMR
+		std::vector<uint32_t> clusters;
+		for (size_t h = 0; h + 1 < hard.size(); h++) {
+			uint32_t start = hard[h], end = hard[h + 1];
+			uint32_t clusterMisses = 0;
+			for (uint32_t t = start; t < end; t++)
+				clusterMisses += misses[t];
+			float limit = threshold * clusterMisses / (end - start);
+
+			cache.Reset();
+			uint32_t partMisses = 0;
+			clusters.push_back(start);
+			for (uint32_t t = start; t < end; t++) {
+				partMisses += cache.Access(input[t * 3]) + cache.Access(input[t * 3 + 1]) + cache.Access(input[t * 3 + 2]);
+				if (t + 1 < end && static_cast<float>(partMisses) / (t - start + 1) <= limit) {
+					clusters.push_back(t + 1);
+					cache.Reset();
+					partMisses = 0;
+					start = t + 1;
+				}
+			}
+		}
+		const uint32_t clusterCount = static_cast<uint32_t>(clusters.size());
+		clusters.push_back(triangleCount);
+
+		// area weighted centroid and normal of every cluster and of the mesh
+		std::vector<Vector3f> centroids(clusterCount, Vector3f(0.0f)), normals(clusterCount, Vector3f(0.0f));
+		Vector3f meshCentroid(0.0f);
+		float meshArea = 0.0f;
+		for (uint32_t c = 0; c < clusterCount; c++) {
+			float area = 0.0f;
+			for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++) {
+				const float* p0 = reinterpret_cast<const float*>(vertices + input[t * 3] * vertexStride);
+				const float* p1 = reinterpret_cast<const float*>(vertices + input[t * 3 + 1] * vertexStride);
+				const float* p2 = reinterpret_cast<const float*>(vertices + input[t * 3 + 2] * vertexStride);
+				Vector3f a(p0[0], p0[1], p0[2]), b(p1[0], p1[1], p1[2]), d(p2[0], p2[1], p2[2]);
+				Vector3f normal = CrossProduct(b - a, d - a);
+				float triangleArea = Length(normal);
+				normals[c] = normals[c] + normal;
+				centroids[c] = centroids[c] + (a + b + d) * (triangleArea / 3.0f);
+				area += triangleArea;
+			}
+			meshCentroid = meshCentroid + centroids[c];
+			meshArea += area;
+			if (area > 0.0f)
+				centroids[c] = centroids[c] * (1.0f / area);
+		}
+		if (meshArea > 0.0f)
+			meshCentroid = meshCentroid * (1.0f / meshArea);
+
+		std::vector<float> keys(clusterCount);
+		std::vector<uint32_t> order(clusterCount);
+		for (uint32_t c = 0; c < clusterCount; c++) {
+			keys[c] = DotProduct(centroids[c] - meshCentroid, Normalize(normals[c]));
+			order[c] = c;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+		Index* out = indices;
+		for (uint32_t c : order) {
+			for (uint32_t i = clusters[c] * 3; i < clusters[c + 1] * 3; i++)
+				*out++ = input[i];
+		}
+	}
+
+	template<typename Index>
+	VertexFetchStatistics AnalyzeFetch(const Index* indices, uint32_t indexCount, uint32_t vertexCount,
+		uint32_t vertexStride, uint32_t cacheSize)
+	{
+		const uint32_t sets = std::max(1u, cacheSize / (kFetchLineSize * kFetchWays));
+		// tag + 1 and last use of every way, 0 tags are empty
+		std::vector<uint64_t> tags(sets * kFetchWays, 0), used(sets * kFetchWays, 0);
+		std::vector<bool> referenced(vertexCount, false);
+		FifoCache shaded(vertexCount);
+
+		VertexFetchStatistics statistics = { 0, 0.0f };
+		uint64_t clock = 0, referencedBytes = 0;
+		for (uint32_t i = 0; i < indexCount; i++) {
+			uint32_t v = indices[i];
+			if (!referenced[v]) {
+				referenced[v] = true;
+				referencedBytes += vertexStride;
+			}
+			if (!shaded.Access(v))
+				continue;
+
+			uint64_t first = uint64_t(v) * vertexStride / kFetchLineSize;
+			uint64_t last = (uint64_t(v) * vertexStride + vertexStride - 1) / kFetchLineSize;
+			for (uint64_t line = first; line <= last; line++) {
+				uint64_t* setTags = &tags[(line % sets) * kFetchWays];
+				uint64_t* setUsed = &used[(line % sets) * kFetchWays];
+				uint32_t way = 0;
+				bool hit = false;
+				for (uint32_t w = 0; w < kFetchWays && !hit; w++) {
+					hit = setTags[w] == line + 1;
+					way = hit ? w : (setUsed[w] < setUsed[way] ? w : way);
+				}
+				if (!hit) {
+					setTags[way] = line + 1;
+					statistics.bytesFetched += kFetchLineSize;
+				}
+				setUsed[way] = ++clock;
+			}
+		}
+		statistics.overfetch = referencedBytes ? static_cast<float>(statistics.bytesFetched) / referencedBytes : 0.0f;
+		return statistics;
+	}
+
+	/// Renumbers the vertices in order of first use; returns how many are
+	/// referenced. remap[old] is the new index, or ~0u when unreferenced.
+	template<typename Index>
+	uint32_t RemapFirstUse(Index* indices, uint32_t indexCount, std::vector<uint32_t>& remap)
+	{
+		uint32_t next = 0;
+		for (uint32_t i = 0; i < indexCount; i++) {
+			uint32_t& target = remap[indices[i]];
+			if (target == ~0u)
+				target = next++;
+			indices[i] = static_cast<Index>(target);
+		}
+		return next;
+	}
+}
+
+VertexCacheStatistics My::AnalyzeVertexCache(const SimpleMesh& mesh, uint32_t cacheSize)
+{
+	if (!IsIndexedTriangleList(mesh) || !cacheSize) {
+		VertexCacheStatistics statistics = { 0, 0.0f, 0.0f };
+		return statistics;
+	}
+	if (mesh.m_indexType == kIndexSize16)
+		return AnalyzeFifo(static_cast<const uint16_t*>(mesh.m_indexBuffer), mesh.m_indexCount, mesh.m_vertexCount, cacheSize);
+	return AnalyzeFifo(static_cast<const uint32_t*>(mesh.m_indexBuffer), mesh.m_indexCount, mesh.m_vertexCount, cacheSize);
+}
+
+bool My::OptimizeVertexCache(SimpleMesh& mesh, uint32_t cacheSize,
+	VertexCacheStatistics* pBefore, VertexCacheStatistics* pAfter)
+{
+	if (!IsIndexedTriangleList(mesh))
+		return false;
+
+	cacheSize = cacheSize < 4 ? 4 : (cacheSize > kMaxCacheSize ? kMaxCacheSize : cacheSize);
+	if (pBefore)
+		*pBefore = AnalyzeVertexCache(mesh);
+
+	if (mesh.m_indexType == kIndexSize16)
+		OptimizeForsyth(static_cast<uint16_t*>(mesh.m_indexBuffer), mesh.m_indexCount, mesh.m_vertexCount, cacheSize);
+	else
+		OptimizeForsyth(static_cast<uint32_t*>(mesh.m_indexBuffer), mesh.m_indexCount, mesh.m_vertexCount, cacheSize);
+
+	if (pAfter)
+		*pAfter = AnalyzeVertexCache(mesh);
+	return true;
+}
+
+bool My::OptimizeOverdraw(SimpleMesh& mesh, float threshold)
+{
+	if (!IsIndexedTriangleList(mesh) || !mesh.m_indexCount)
+		return false;
+
+	const uint8_t* vertices = static_cast<const uint8_t*>(mesh.m_vertexBuffer);
+	if (mesh.m_indexType == kIndexSize16)
+		OptimizeOverdrawClusters(static_cast<uint16_t*>(mesh.m_indexBuffer), mesh.m_indexCount, mesh.m_vertexCount,
+			vertices, mesh.m_vertexStride, threshold);
+	else
+		OptimizeOverdrawClusters(static_cast<uint32_t*>(mesh.m_indexBuffer), mesh.m_indexCount, mesh.m_vertexCount,
+			vertices, mesh.m_vertexStride, threshold);
+	return true;
+}
+
+VertexFetchStatistics My::AnalyzeVertexFetch(const SimpleMesh& mesh, uint32_t cacheSize)
+{
+	if (!IsIndexedTriangleList(mesh)) {
+		VertexFetchStatistics statistics = { 0, 0.0f };
+		return statistics;
+	}
+
+	if (mesh.m_indexType == kIndexSize16)
+		return AnalyzeFetch(static_cast<const uint16_t*>(mesh.m_indexBuffer), mesh.m_indexCount, mesh.m_vertexCount,
+			mesh.m_vertexStride, cacheSize);
+	return AnalyzeFetch(static_cast<const uint32_t*>(mesh.m_indexBuffer), mesh.m_indexCount, mesh.m_vertexCount,
+		mesh.m_vertexStride, cacheSize);
+}
+
+bool My::OptimizeVertexFetch(SimpleMesh& mesh)
+{
+	if (!IsIndexedTriangleList(mesh))
+		return false;
+
+	std::vector<uint32_t> remap(mesh.m_vertexCount, ~0u);
+	uint32_t vertexCount;
+	if (mesh.m_indexType == kIndexSize16)
+		vertexCount = RemapFirstUse(static_cast<uint16_t*>(mesh.m_indexBuffer), mesh.m_indexCount, remap);
+	else
+		vertexCount = RemapFirstUse(static_cast<uint32_t*>(mesh.m_indexBuffer), mesh.m_indexCount, remap);
+
+	const uint32_t stride = mesh.m_vertexStride;
+	const uint8_t* in = static_cast<const uint8_t*>(mesh.m_vertexBuffer);
+	uint8_t* out = new uint8_t[vertexCount * stride];
+	for (uint32_t v = 0; v < mesh.m_vertexCount; v++) {
+		if (remap[v] != ~0u)
+			memcpy(out + remap[v] * stride, in + v * stride, stride);
+	}
+
+	delete[] static_cast<uint8_t*>(mesh.m_vertexBuffer);
+	mesh.m_vertexBuffer = out;
+	mesh.m_vertexCount = vertexCount;
+	mesh.m_vertexBufferSize = vertexCount * stride;
+	return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "Mesh.h"
+
+namespace My {
+	// Reordering passes for indexed triangle lists (kPrimitiveTypeTriList,
+	// 16 or 32-bit indices). They change the order of the triangles or of
+	// the vertices, never the triangles themselves, so the rendered image
+	// stays the same. Run them in the order they are declared:
+	// OptimizeVertexCache, OptimizeOverdraw, then OptimizeVertexFetch.
+	// Passes that read positions expect a float3 at the start of each
+	// vertex, as MeshUtility does.
+
+	/// Post-transform vertex cache behaviour of an index buffer.
+	struct VertexCacheStatistics
+	{
+		uint32_t misses;     ///< vertex shader invocations
+		float    acmr;       ///< misses per triangle: 3 worst, about 0.5 best on large regular meshes
+		float    atvr;       ///< misses per referenced vertex: 1 means every vertex is shaded once
+	};
+
+	/// Memory traffic of the vertex fetches behind an index buffer.
+	struct VertexFetchStatistics
+	{
+		uint64_t bytesFetched;    ///< cache lines read from memory, in bytes
+		float    overfetch;       ///< bytesFetched over the size of the referenced vertices; 1 is ideal
+	};
+
+	/// Replays the index buffer through a FIFO cache of 'cacheSize' entries,
+	/// the usual model of the post-transform cache.
+	VertexCacheStatistics AnalyzeVertexCache(const SimpleMesh& mesh, uint32_t cacheSize = 16);
+
+	/// Reorders the triangles for the post-transform vertex cache with Tom
+	/// Forsyth's linear-speed algorithm: triangles are picked greedily by a
+	/// score favouring vertices recently used in a simulated LRU cache of
+	/// 'cacheSize' entries (at most 64) and vertices with few triangles left.
+	/// The result is good for any real cache size, so the default need not
+	/// match the hardware. Optional statistics from AnalyzeVertexCache() with
+	/// its default cache are written before and after. Returns false,
+	/// leaving the mesh alone, when it is not an indexed triangle list.
+	bool OptimizeVertexCache(SimpleMesh& mesh, uint32_t cacheSize = 32,
+		VertexCacheStatistics* pBefore = nullptr, VertexCacheStatistics* pAfter = nullptr);
+
+	/// Reorders the triangles to reduce overdraw without undoing the vertex
+	/// cache order (Sander, Nehab and Barczak, "Fast Triangle Reordering for
+	/// Vertex Locality and Reduced Overdraw"). The cache-ordered triangles
+	/// are cut into clusters where the cache restarts, and further where a
+	/// cluster's ACMR is within 'threshold' of its parent's; clusters facing
+	/// away from the mesh center, which tend to occlude the others, are
+	/// drawn first. A larger threshold trades vertex cache efficiency for
+	/// less overdraw. Returns false, leaving the mesh alone, when it is not
+	/// an indexed triangle list.
+	bool OptimizeOverdraw(SimpleMesh& mesh, float threshold = 1.05f);
+
+	/// Simulates the fetches of the vertex shader invocations left by a
+	/// 16-entry post-transform cache through a 4-way set-associative cache of
+	/// 'cacheSize' bytes in 64-byte lines, the vertex buffer starting on a
+	/// line.
+	VertexFetchStatistics AnalyzeVertexFetch(const SimpleMesh& mesh, uint32_t cacheSize = 16384);
+
+	/// Reorders the vertices in the order the index buffer first uses them
+	/// and remaps the indices, so fetches walk the vertex buffer linearly.
+	/// Unreferenced vertices are dropped. The vertex buffer is replaced by
+	/// one allocated with new uint8_t[] (the old one is released with
+	/// delete[]). Returns false, leaving the mesh alone, when it is not an
+	/// indexed triangle list.
+	bool OptimizeVertexFetch(SimpleMesh& mesh);
+}
@@ -0,0 +1,603 @@
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "MeshSimplifier.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshUtility.hpp"
+#include "Parallel.hpp"
+
+using namespace My;
+
+namespace {
+	// planes holding border and seam edges weigh this many times a face of
+	// the same size, so they stay put while the interior simplifies
+	const float kEdgeWeight = 10.0f;
+
+	// a collapse is rejected when a remaining triangle turns by more than
+	// about 75 degrees (cosine of the angle between the normals), shrinks
+	// to a sliver (ratio of the areas after and before), or ends up facing
+	// away from the LOD 0 surface around its vertices
+	const float kMinNormalCosine = 0.25f;
+	const float kMinAreaRatio = 1e-3f;
+
+	const uint32_t kNone = ~0u;
+
+	enum VertexKind
+	{
+		kVertexManifold,  ///< interior, collapses onto any neighbour
+		kVertexBorder,    ///< on an open edge, collapses along it
+		kVertexSeam,      ///< one of two vertices sharing a position, collapses along the seam with its sibling
+		kVertexLocked,    ///< anything else: corners, seam ends, non-manifold fans
+	};
+
+	/// Sum of weighted squared distances to planes, as the symmetric matrix
+	/// A, vector b and constant c of p.A.p + 2 b.p + c.
+	struct Quadric
+	{
+		double a00, a11, a22, a01, a02, a12;
+		double b0, b1, b2;
+		double c;
+		double weight;
+	};
+
+	void AddPlane(Quadric& q, const double n[3], double d, double weight)
+	{
+		q.a00 += weight * n[0] * n[0];
+		q.a11 += weight * n[1] * n[1];
+		q.a22 += weight * n[2] * n[2];
+		q.a01 += weight * n[0] * n[1];
+		q.a02 += weight * n[0] * n[2];
+		q.a12 += weight * n[1] * n[2];
+		q.b0 += weight * n[0] * d;
+		q.b1 += weight * n[1] * d;
+		q.b2 += weight * n[2] * d;
+		q.c += weight * d * d;
+		q.weight += weight;
+	}
+
+	void MergeQuadric(Quadric& q, const Quadric& other)
+	{
+		q.a00 += other.a00; q.a11 += other.a11; q.a22 += other.a22;
+		q.a01 += other.a01; q.a02 += other.a02; q.a12 += other.a12;
+		q.b0 += other.b0; q.b1 += other.b1; q.b2 += other.b2;
+		q.c += other.c;
+		q.weight += other.weight;
+	}
+
+	/// Mean squared distance from p to the planes of q.
+	double QuadricError(const Quadric& q, const float* p)
+	{
+		double x = p[0], y = p[1], z = p[2];
+		double e = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z
+			+ 2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z)
+			+ 2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+		return q.weight > 0.0 ? std::max(e, 0.0) / q.weight : 0.0;
+	}
+
+	/// Plane through p with normal n (scaled by 'length'); false when degenerate.
+	bool NormalizePlane(double n[3], const float* p, double& d, double& length)
+	{
+		length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length <= 0.0)
+			return false;
+		n[0] /= length; n[1] /= length; n[2] /= length;
+		d = -(n[0] * p[0] + n[1] * p[1] + n[2] * p[2]);
+		return true;
+	}
+
+	void Cross(double out[3], const float* a, const float* b, const float* c)
+	{
+		double u[3] = { double(b[0]) - a[0], double(b[1]) - a[1], double(b[2]) - a[2] };
+		double v[3] = { double(c[0]) - a[0], double(c[1]) - a[1], double(c[2]) - a[2] };
+		out[0] = u[1] * v[2] - u[2] * v[1];
+		out[1] = u[2] * v[0] - u[0] * v[2];
+		out[2] = u[0] * v[1] - u[1] * v[0];
+	}
+
+	struct Collapse
+	{
+		uint32_t v, target;
+		double   error;
+	};
+
+	/// Edge collapse simplifier over 32-bit indices. Vertices at the same
+	/// position share one quadric, kept by the first of them (m_position).
+	class Simplifier
+	{
+	public:
+		Simplifier(const uint8_t* vertices, uint32_t vertexStride, uint32_t vertexCount,
+			const std::vector<uint32_t>& indices)
+			: m_vertices(vertices), m_stride(vertexStride), m_vertexCount(vertexCount)
+			, m_position(vertexCount), m_sibling(vertexCount), m_kind(vertexCount, kVertexLocked)
+			, m_openIn(vertexCount, kNone), m_openOut(vertexCount, kNone), m_quadrics(vertexCount)
+			, m_normals(vertexCount * 3, 0.0)
+		{
+			std::vector<uint8_t> openEdges;
+			LinkPositions();
+			ClassifyVertices(indices, openEdges);
+			BuildQuadrics(indices, openEdges);
+		}
+
+		/// Collapses 'indices' in place towards targetIndexCount; returns the
+		/// largest error of the collapses done.
+		float Simplify(std::vector<uint32_t>& indices, uint32_t targetIndexCount, float targetError);
+
+	private:
+		const float* Position(uint32_t v) const
+		{
+			return reinterpret_cast<const float*>(m_vertices + size_t(v) * m_stride);
+		}
+
+		uint64_t Edge(uint32_t a, uint32_t b) const { return (uint64_t(a) << 32) | b; }
+
+		void LinkPositions();
+		/// openEdges[i] tells whether the edge from indices[i] to the next
+		/// vertex of its triangle has no twin.
+		void ClassifyVertices(const std::vector<uint32_t>& indices, std::vector<uint8_t>& openEdges);
+		void BuildQuadrics(const std::vector<uint32_t>& indices, const std::vector<uint8_t>& openEdges);
+		bool CanCollapse(uint32_t v, uint32_t target) const;
+		/// Joins the open edges around v, collapsed onto 'target', so the
+		/// border or seam chain skips the removed vertex.
+		void RelinkOpenEdges(uint32_t v, uint32_t target);
+		/// Target of v's seam sibling when v collapses onto 'target'.
+		uint32_t SiblingTarget(uint32_t v, uint32_t target) const
+		{
+			uint32_t w = m_sibling[v];
+			return target == m_openOut[v] ? m_openIn[w] : m_openOut[w];
+		}
+		/// Checks the triangles around v for folds when v moves onto
+		/// 'target'; adds those that vanish to 'removed'.
+		bool CheckTriangles(const std::vector<uint32_t>& indices, uint32_t v, uint32_t target, uint32_t& removed) const;
+		void LockRing(const std::vector<uint32_t>& indices, uint32_t v, std::vector<uint8_t>& locked) const;
+
+		const uint8_t* m_vertices;
+		uint32_t m_stride;
+		uint32_t m_vertexCount;
+
+		std::vector<uint32_t> m_position;   // first vertex at the same position
+		std::vector<uint32_t> m_sibling;    // next vertex at the same position, in a ring
+		std::vector<uint8_t>  m_kind;
+		// the open (unpaired) half-edge leaving and reaching every vertex,
+		// kNone without one, the vertex itself with several
+		std::vector<uint32_t> m_openIn, m_openOut;
+		std::vector<Quadric>  m_quadrics;   // indexed by m_position
+		std::vector<double>   m_normals;    // unit LOD 0 normal, 3 per m_position
+
+		// triangles around every vertex, rebuilt every pass
+		std::vector<uint32_t> m_adjacencyOffsets, m_adjacency;
+	};
+
+	void Simplifier::LinkPositions()
+	{
+		std::vector<uint32_t> order(m_vertexCount);
+		for (uint32_t v = 0; v < m_vertexCount; v++)
+			order[v] = v;
+		std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+			const float* pa = Position(a);
+			const float* pb = Position(b);
+			if (pa[0] != pb[0])
+				return pa[0] < pb[0];
+			if (pa[1] != pb[1])
+				return pa[1] < pb[1];
+			if (pa[2] != pb[2])
+				return pa[2] < pb[2];
+			return a < b;
+		});
+
+		for (uint32_t first = 0; first < m_vertexCount;) {
+			uint32_t last = first + 1;
+			while (last < m_vertexCount && !memcmp(Position(order[first]), Position(order[last]), 3 * sizeof(float)))
+				last++;
+			for (uint32_t i = first; i < last; i++) {
+				m_position[order[i]] = order[first];
+				m_sibling[order[i]] = order[i + 1 < last ? i + 1 : first];
+			}
+			first = last;
+		}
+	}
+
+	void Simplifier::ClassifyVertices(const std::vector<uint32_t>& indices, std::vector<uint8_t>& openEdges)
+	{
+		// sorted half-edges, looked up by binary search
+		std::vector<uint64_t> edges(indices.size()), positionEdges(indices.size());
+		for (size_t i = 0; i < indices.size(); i++) {
+			uint32_t a = indices[i], b = indices[i % 3 == 2 ? i - 2 : i + 1];
+			edges[i] = Edge(a, b);
+			positionEdges[i] = Edge(m_position[a], m_position[b]);
+		}
+		std::sort(edges.begin(), edges.end());
+		std::sort(positionEdges.begin(), positionEdges.end());
+		auto hasEdge = [](const std::vector<uint64_t>& sorted, uint64_t edge) {
+			return std::binary_search(sorted.begin(), sorted.end(), edge);
+		};
+
+		openEdges.assign(indices.size(), 0);
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			for (int e = 0; e < 3; e++) {
+				uint32_t a = indices[i + e], b = indices[i + (e + 1) % 3];
+				if (hasEdge(edges, Edge(b, a)))
+					continue;
+				openEdges[i + e] = 1;
+				m_openOut[a] = m_openOut[a] == kNone ? b : a;
+				m_openIn[b] = m_openIn[b] == kNone ? a : b;
+			}
+		}
+
+		auto single = [this](uint32_t v) {
+			return m_openIn[v] != kNone && m_openIn[v] != v && m_openOut[v] != kNone && m_openOut[v] != v;
+		};
+		for (uint32_t v = 0; v < m_vertexCount; v++) {
+			uint32_t w = m_sibling[v];
+			if (w == v) {
+				if (m_openIn[v] == kNone && m_openOut[v] == kNone)
+					m_kind[v] = kVertexManifold;
+				else if (single(v)
+					&& !hasEdge(positionEdges, Edge(m_position[m_openOut[v]], m_position[v]))
+					&& !hasEdge(positionEdges, Edge(m_position[v], m_position[m_openIn[v]])))
+					m_kind[v] = kVertexBorder;
+			}
+			else if (m_sibling[w] == v && single(v) && single(w)
+				&& m_position[m_openOut[v]] == m_position[m_openIn[w]]
+				&& m_position[m_openIn[v]] == m_position[m_openOut[w]]
+				&& m_position[m_openOut[v]] != m_position[m_openIn[v]]) {
+				m_kind[v] = kVertexSeam;
+			}
+		}
+	}
+
+	void Simplifier::BuildQuadrics(const std::vector<uint32_t>& indices, const std::vector<uint8_t>& openEdges)
+	{
+		memset(m_quadrics.data(), 0, m_quadrics.size() * sizeof(Quadric));
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const float* p[3] = { Position(indices[i]), Position(indices[i + 1]), Position(indices[i + 2]) };
+			double n[3], d, length;
+			Cross(n, p[0], p[1], p[2]);
+			if (!NormalizePlane(n, p[0], d, length))
+				continue;
+			for (int k = 0; k < 3; k++) {
+				uint32_t position = m_position[indices[i + k]];
+				AddPlane(m_quadrics[position], n, d, length * 0.5);
+				for (int j = 0; j < 3; j++)
+					m_normals[position * 3 + j] += n[j] * length;
+			}
+
+			// a plane through every open edge, perpendicular to the face
+			for (int e = 0; e < 3; e++) {
+				if (!openEdges[i + e])
+					continue;
+				uint32_t a = indices[i + e], b = indices[i + (e + 1) % 3];
+				const float* pa = Position(a);
+				const float* pb = Position(b);
+				double edge[3] = { double(pb[0]) - pa[0], double(pb[1]) - pa[1], double(pb[2]) - pa[2] };
+				double m[3] = { edge[1] * n[2] - edge[2] * n[1], edge[2] * n[0] - edge[0] * n[2], edge[0] * n[1] - edge[1] * n[0] };
+				double md, mLength;
+				if (!NormalizePlane(m, pa, md, mLength))
+					continue;
+				// mLength is the squared edge length as n is a unit vector
+				AddPlane(m_quadrics[m_position[a]], m, md, mLength * kEdgeWeight);
+				AddPlane(m_quadrics[m_position[b]], m, md, mLength * kEdgeWeight);
+			}
+		}
+
+		for (uint32_t v = 0; v < m_vertexCount; v++) {
+			double* normal = &m_normals[v * 3];
+			double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (length > 0.0) {
+				normal[0] /= length; normal[1] /= length; normal[2] /= length;
+			}
+		}
+	}
+
+	bool Simplifier::CanCollapse(uint32_t v, uint32_t target) const
+	{
+		switch (m_kind[v]) {
+		case kVertexManifold:
+			return true;
+		case kVertexBorder:
+		case kVertexSeam:
+			return target == m_openOut[v] || target == m_openIn[v];
+		default:
+			return false;
+		}
+	}
+
+	void Simplifier::RelinkOpenEdges(uint32_t v, uint32_t target)
+	{
+		// pointers set to the vertex itself mark several open edges and
+		// stay as they are
+		if (target == m_openOut[v]) {
+			uint32_t previous = m_openIn[v];
+			if (m_openIn[target] == v)
+				m_openIn[target] = previous;
+			if (m_openOut[previous] == v)
+				m_openOut[previous] = target;
+		}
+		else if (target == m_openIn[v]) {
+			uint32_t next = m_openOut[v];
+			if (m_openOut[target] == v)
+				m_openOut[target] = next;
+			if (m_openIn[next] == v)
+				m_openIn[next] = target;
+		}
+	}
+
+	bool Simplifier::CheckTriangles(const std::vector<uint32_t>& indices, uint32_t v, uint32_t target,
+		uint32_t& removed) const
+	{
+		const float* moved = Position(target);
+		for (uint32_t i = m_adjacencyOffsets[v]; i < m_adjacencyOffsets[v + 1]; i++) {
+			const uint32_t* triangle = &indices[m_adjacency[i] * 3];
+			if (triangle[0] == target || triangle[1] == target || triangle[2] == target) {
+				removed++;
+				continue;
+			}
+
+			const float* before[3], *after[3];
+			for (int k = 0; k < 3; k++) {
+				// a vertex at the target's position but another attribute
+				// would leave a sliver across a seam
+				if (triangle[k] != v && m_position[triangle[k]] == m_position[target])
+					return false;
+				before[k] = Position(triangle[k]);
+				after[k] = triangle[k] == v ? moved : before[k];
+			}
+			double n0[3], n1[3];
+			Cross(n0, before[0], before[1], before[2]);
+			Cross(n1, after[0], after[1], after[2]);
+			double length0 = sqrt(n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]);
+			double length1 = sqrt(n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]);
+			double dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+			if (dot <= kMinNormalCosine * length0 * length1 || length1 <= kMinAreaRatio * length0)
+				return false;
+
+			// small turns add up over many collapses; the original surface
+			// does not move
+			double surface = 0.0;
+			for (int k = 0; k < 3; k++) {
+				const double* normal = &m_normals[m_position[triangle[k] == v ? target : triangle[k]] * 3];
+				surface += n1[0] * normal[0] + n1[1] * normal[1] + n1[2] * normal[2];
+			}
+			if (surface <= 0.0)
+				return false;
+		}
+		return true;
+	}
+
+	void Simplifier::LockRing(const std::vector<uint32_t>& indices, uint32_t v, std::vector<uint8_t>& locked) const
+	{
+		for (uint32_t i = m_adjacencyOffsets[v]; i < m_adjacencyOffsets[v + 1]; i++) {
+			const uint32_t* triangle = &indices[m_adjacency[i] * 3];
+			locked[triangle[0]] = locked[triangle[1]] = locked[triangle[2]] = 1;
+		}
+	}
+
+	float Simplifier::Simplify(std::vector<uint32_t>& indices, uint32_t targetIndexCount, float targetError)
+	{
+		const double maxError = double(targetError) * targetError;
+		double resultError = 0.0;
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> remap(m_vertexCount);
+		std::vector<uint8_t> locked(m_vertexCount);
+
+		while (indices.size() > targetIndexCount) {
+			uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+			m_adjacencyOffsets.assign(m_vertexCount + 1, 0);
+			for (uint32_t index : indices)
+				m_adjacencyOffsets[index + 1]++;
+			for (uint32_t v = 0; v < m_vertexCount; v++)
+				m_adjacencyOffsets[v + 1] += m_adjacencyOffsets[v];
+			m_adjacency.resize(indices.size());
+			std::vector<uint32_t> fill(m_adjacencyOffsets.begin(), m_adjacencyOffsets.end() - 1);
+			for (uint32_t i = 0; i < indices.size(); i++)
+				m_adjacency[fill[indices[i]]++] = i / 3;
+
+			// the cheaper direction of every edge that may collapse
+			collapses.clear();
+			for (uint32_t i = 0; i < indices.size(); i += 3) {
+				for (int e = 0; e < 3; e++) {
+					uint32_t a = indices[i + e], b = indices[i + (e + 1) % 3];
+					// the twin of an interior edge has it covered
+					if (a == b || (a > b && m_openOut[a] != b))
+						continue;
+					Collapse best = { kNone, kNone, 0.0 };
+					if (CanCollapse(a, b))
+						best = { a, b, QuadricError(m_quadrics[m_position[a]], Position(b)) };
+					if (CanCollapse(b, a)) {
+						double error = QuadricError(m_quadrics[m_position[b]], Position(a));
+						if (best.v == kNone || error < best.error)
+							best = { b, a, error };
+					}
+					if (best.v != kNone && best.error <= maxError)
+						collapses.push_back(best);
+				}
+			}
+			if (collapses.empty())
+				break;
+
+			// a pass takes the cheaper half of the candidates so that costly
+			// collapses wait for the neighbourhoods to settle
+			auto cheaper = [](const Collapse& x, const Collapse& y) { return x.error < y.error; };
+			size_t considered = (collapses.size() + 1) / 2;
+			std::nth_element(collapses.begin(), collapses.begin() + (considered - 1), collapses.end(), cheaper);
+			std::sort(collapses.begin(), collapses.begin() + considered, cheaper);
+
+			const uint32_t targetTriangles = targetIndexCount / 3;
+			for (uint32_t v = 0; v < m_vertexCount; v++)
+				remap[v] = v;
+			std::fill(locked.begin(), locked.end(), 0);
+			uint32_t done = 0;
+			for (size_t c = 0; c < considered && triangleCount > targetTriangles; c++) {
+				uint32_t v = collapses[c].v, target = collapses[c].target;
+				if (locked[v] || locked[target])
+					continue;
+
+				uint32_t removed = 0;
+				uint32_t w = kNone, wTarget = kNone;
+				if (m_kind[v] == kVertexSeam) {
+					w = m_sibling[v];
+					wTarget = SiblingTarget(v, target);
+					if (locked[w] || locked[wTarget] || !CheckTriangles(indices, w, wTarget, removed))
+						continue;
+				}
+				if (!CheckTriangles(indices, v, target, removed))
+					continue;
+
+				remap[v] = target;
+				LockRing(indices, v, locked);
+				locked[target] = 1;
+				if (w != kNone) {
+					remap[w] = wTarget;
+					LockRing(indices, w, locked);
+					locked[wTarget] = 1;
+					RelinkOpenEdges(w, wTarget);
+				}
+				if (m_kind[v] != kVertexManifold)
+					RelinkOpenEdges(v, target);
+				MergeQuadric(m_quadrics[m_position[target]], m_quadrics[m_position[v]]);
+				resultError = std::max(resultError, collapses[c].error);
+				triangleCount -= std::min(removed, triangleCount);
+				done++;
+			}
+			if (!done)
+				break;
+
+			size_t write = 0;
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				uint32_t a = remap[indices[i]], b = remap[indices[i + 1]], c = remap[indices[i + 2]];
+				if (a == b || b == c || c == a)
+					continue;
+				indices[write++] = a;
+				indices[write++] = b;
+				indices[write++] = c;
+			}
+			indices.resize(write);
+		}
+		return static_cast<float>(sqrt(resultError));
+	}
+
+	bool IsSimplifiable(const SimpleMesh& mesh)
+	{
+		return mesh.m_primitiveType == kPrimitiveTypeTriList && mesh.m_indexBuffer && mesh.m_indexCount % 3 == 0
+			&& (mesh.m_indexType == kIndexSize16 || mesh.m_indexType == kIndexSize32)
+			&& mesh.m_vertexBuffer && mesh.m_vertexStride >= 3 * sizeof(float);
+	}
+
+	std::vector<uint32_t> ReadIndices(const SimpleMesh& mesh)
+	{
+		if (mesh.m_indexType == kIndexSize16) {
+			const uint16_t* indices = static_cast<const uint16_t*>(mesh.m_indexBuffer);
+			return std::vector<uint32_t>(indices, indices + mesh.m_indexCount);
+		}
+		const uint32_t* indices = static_cast<const uint32_t*>(mesh.m_indexBuffer);
+		return std::vector<uint32_t>(indices, indices + mesh.m_indexCount);
+	}
+
+	void WriteIndices(const std::vector<uint32_t>& indices, IndexSize indexType, void* destination)
+	{
+		if (indexType == kIndexSize16) {
+			uint16_t* out = static_cast<uint16_t*>(destination);
+			for (size_t i = 0; i < indices.size(); i++)
+				out[i] = static_cast<uint16_t>(indices[i]);
+		}
+		else {
+			memcpy(destination, indices.data(), indices.size() * sizeof(uint32_t));
+		}
+	}
+}
+
+uint32_t My::SimplifyMesh(const SimpleMesh& mesh, void* destination, uint32_t targetIndexCount,
+	float targetError, float* pResultError)
+{
+	if (pResultError)
+		*pResultError = 0.0f;
+	if (!IsSimplifiable(mesh))
+		return 0;
+
+	std::vector<uint32_t> indices = ReadIndices(mesh);
+	Simplifier simplifier(static_cast<const uint8_t*>(mesh.m_vertexBuffer), mesh.m_vertexStride, mesh.m_vertexCount, indices);
+	float error = simplifier.Simplify(indices, targetIndexCount, targetError);
+	WriteIndices(indices, mesh.m_indexType, destination);
+	if (pResultError)
+		*pResultError = error;
+	return static_cast<uint32_t>(indices.size());
+}
+
+bool My::BuildMeshLods(SimpleMesh& mesh, MeshLodChain& chain, const MeshLodSettings& settings)
+{
+	chain.lodCount = 0;
+	if (!IsSimplifiable(mesh))
+		return false;
+
+	UpdateMeshBounds(mesh);
+	const std::vector<uint32_t> source = ReadIndices(mesh);
+	const float maxError = settings.maxError * mesh.m_boundingSphere[3];
+	const uint32_t lodCount = std::min(std::max(settings.lodCount, 1u), kMaxMeshLods);
+
+	std::vector<std::vector<uint32_t>> levels(1, source);
+	chain.lods[0] = { 0, mesh.m_indexCount, 0.0f };
+	chain.lodCount = 1;
+	// every level continues from the previous one; the merged quadrics keep
+	// measuring the error against LOD 0
+	std::vector<uint32_t> indices = source;
+	Simplifier simplifier(static_cast<const uint8_t*>(mesh.m_vertexBuffer), mesh.m_vertexStride,
+		mesh.m_vertexCount, indices);
+	for (uint32_t lod = 1; lod < lodCount; lod++) {
+		const MeshLod& previous = chain.lods[lod - 1];
+		uint32_t target = static_cast<uint32_t>(previous.indexCount / 3 * settings.triangleRatio) * 3;
+		float error = simplifier.Simplify(indices, target, maxError);
+
+		// stop once the error limit keeps a level from simplifying much
+		uint32_t indexCount = static_cast<uint32_t>(indices.size());
+		if (!indexCount || indexCount > previous.indexCount - previous.indexCount / 10)
+			break;
+		chain.lods[lod] = { previous.firstIndex + previous.indexCount, indexCount, std::max(error, previous.error) };
+		chain.lodCount++;
+		levels.push_back(indices);
+		if (indexCount > target)
+			break;
+	}
+
+	const MeshLod& last = chain.lods[chain.lodCount - 1];
+	const uint32_t indexCount = last.firstIndex + last.indexCount;
+	const uint32_t indexSize = mesh.m_indexType == kIndexSize16 ? sizeof(uint16_t) : sizeof(uint32_t);
+	uint8_t* buffer = new uint8_t[indexCount * indexSize];
+	for (uint32_t lod = 0; lod < chain.lodCount; lod++) {
+		void* destination = buffer + chain.lods[lod].firstIndex * indexSize;
+		WriteIndices(levels[lod], mesh.m_indexType, destination);
+		if (lod) {
+			SimpleMesh view = mesh;
+			view.m_indexBuffer = destination;
+			view.m_indexCount = chain.lods[lod].indexCount;
+			view.m_indexBufferSize = view.m_indexCount * indexSize;
+			OptimizeVertexCache(view);
+		}
+	}
+
+	delete[] static_cast<uint8_t*>(mesh.m_indexBuffer);
+	mesh.m_indexBuffer = buffer;
+	mesh.m_indexCount = indexCount;
+	mesh.m_indexBufferSize = indexCount * indexSize;
+	return true;
+}
+
+bool My::BuildMeshLods(SimpleMesh* meshes, MeshLodChain* chains, uint32_t meshCount,
+	const MeshLodSettings& settings, uint32_t jobs)
+{
+	std::vector<uint8_t> built(meshCount);
+	ParallelFor(meshCount, 1, jobs, [&](uint32_t first, uint32_t last) {
+		for (uint32_t i = first; i < last; i++)
+			built[i] = BuildMeshLods(meshes[i], chains[i], settings);
+	});
+	return std::find(built.begin(), built.end(), 0) == built.end();
+}
+
+uint32_t My::SelectMeshLod(const MeshLodChain& chain, float distance, float projectionScale, float pixelError)
+{
+	for (uint32_t lod = chain.lodCount; lod > 1; lod--) {
+		if (chain.lods[lod - 1].error * projectionScale <= pixelError * distance)
+			return lod - 1;
+	}
+	return 0;
+}
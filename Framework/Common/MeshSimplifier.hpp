@@ -0,0 +1,72 @@
+#pragma once
+#include "Mesh.h"
+
+namespace My {
+	// Level of detail generation for indexed triangle lists whose vertices
+	// start with a float3 position. Simplification collapses edges onto one
+	// of their vertices, so every level is an index buffer into the vertex
+	// buffer of the source mesh and one vertex buffer serves the whole chain.
+	// Vertices sharing a position but not their other attributes (uv seams,
+	// hard edges) only move along the seam, together, and open borders only
+	// along the border, so discontinuities keep their shape.
+
+	const uint32_t kMaxMeshLods = 8;
+
+	/// One level: a range of the mesh's index buffer.
+	struct MeshLod
+	{
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		float    error;      ///< object space distance the surface may be off from LOD 0
+	};
+
+	/// Levels finest first; lods[0] holds the source triangles, with no error.
+	struct MeshLodChain
+	{
+		MeshLod  lods[kMaxMeshLods];
+		uint32_t lodCount;
+	};
+
+	struct MeshLodSettings
+	{
+		uint32_t lodCount = 4;          ///< levels wanted, LOD 0 included, at most kMaxMeshLods
+		float    triangleRatio = 0.5f;  ///< triangles of a level over those of the previous one
+		float    maxError = 0.02f;      ///< relative to the bounding sphere radius; the chain ends there
+	};
+
+	/// Simplifies the mesh towards 'targetIndexCount' indices with quadric
+	/// error metrics (Garland and Heckbert), cheapest collapse first, without
+	/// collapses that would move the surface by more than 'targetError'
+	/// (object space) or fold a triangle over. Writes the indices, in the
+	/// mesh's index type, to 'destination', which must have room for
+	/// m_indexCount of them, and returns how many were written; 0 when the
+	/// mesh is not an indexed triangle list. pResultError receives the error
+	/// reached.
+	uint32_t SimplifyMesh(const SimpleMesh& mesh, void* destination, uint32_t targetIndexCount,
+		float targetError, float* pResultError = nullptr);
+
+	/// Appends simplified levels to the index buffer, each 'triangleRatio'
+	/// the triangles of the previous one, until settings.lodCount levels or
+	/// maxError. Every level continues from the previous one and is ordered
+	/// for the vertex cache by OptimizeVertexCache(). Run the MeshOptimizer
+	/// passes on LOD 0 before, except OptimizeVertexFetch(), which is best
+	/// run on the whole chain after. The index buffer is replaced by one allocated
+	/// with new uint8_t[] (the old one is released with delete[]) and
+	/// m_indexCount then covers every level: draw the ranges in 'chain'.
+	/// The bounds are refreshed by UpdateMeshBounds(). Returns false, with
+	/// lodCount 0 and the mesh left alone, when it is not an indexed
+	/// triangle list.
+	bool BuildMeshLods(SimpleMesh& mesh, MeshLodChain& chain, const MeshLodSettings& settings = MeshLodSettings());
+
+	/// BuildMeshLods() on meshes[i] and chains[i], meshes split across 'jobs'
+	/// threads (0: one per hardware thread). Returns false when any failed.
+	bool BuildMeshLods(SimpleMesh* meshes, MeshLodChain* chains, uint32_t meshCount,
+		const MeshLodSettings& settings = MeshLodSettings(), uint32_t jobs = 0);
+
+	/// Coarsest level whose error covers at most 'pixelError' pixels at
+	/// 'distance' from the camera, both in object units (divide world
+	/// distances by the object's scale). projectionScale converts a length at
+	/// distance 1 to pixels: viewport height / 2 times the [1][1] element of
+	/// the projection, for PerspectiveFovLHMatrix() 1 / tan(fov / 2).
+	uint32_t SelectMeshLod(const MeshLodChain& chain, float distance, float projectionScale, float pixelError = 1.0f);
+}
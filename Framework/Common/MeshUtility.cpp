@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <math.h>
+#include "MeshUtility.hpp"
+#include "Bounds.h"
+#include "Intersection.h"
+#include "Packing.h"
+#include "Parallel.hpp"
+
+using namespace My;
+
+void My::VertexBounds::Reset()
+{
+	for (int i = 0; i < 3; i++) {
+		minimum[i] = std::numeric_limits<float>::infinity();
+		maximum[i] = -std::numeric_limits<float>::infinity();
+		sum[i] = 0.0;
+	}
+	count = 0;
+}
+
+void My::VertexBounds::Merge(const VertexBounds& other)
+{
+	for (int i = 0; i < 3; i++) {
+		minimum[i] = other.minimum[i] < minimum[i] ? other.minimum[i] : minimum[i];
+		maximum[i] = other.maximum[i] > maximum[i] ? other.maximum[i] : maximum[i];
+		sum[i] += other.sum[i];
+	}
+	count += other.count;
+}
+
+Vector3f My::VertexBounds::Centroid() const
+{
+	if (!count)
+		return Vector3f(0.0f, 0.0f, 0.0f);
+
+	return Vector3f(static_cast<float>(sum[0] / count),
+		static_cast<float>(sum[1] / count),
+		static_cast<float>(sum[2] / count));
+}
+
+AABB My::VertexBounds::Box() const
+{
+	AABB box;
+	if (!count) {
+		box.minimum = box.maximum = Vector3f(0.0f, 0.0f, 0.0f);
+	} else {
+		box.minimum = Vector3f(minimum[0], minimum[1], minimum[2]);
+		box.maximum = Vector3f(maximum[0], maximum[1], maximum[2]);
+	}
+	return box;
+}
+
+BoundingSphere My::VertexBounds::Sphere() const
+{
+	AABB box = Box();
+	BoundingSphere sphere;
+	sphere.center = box.Center();
+	sphere.radius = Length(box.Extent());
+	return sphere;
+}
+
+void My::AccumulateVertexBounds(const void* vertexBuffer, uint32_t vertexStride, uint32_t attributeOffset,
+	uint32_t first, uint32_t count, VertexBounds& bounds)
+{
+	const float* positions = reinterpret_cast<const float*>(
+		static_cast<const uint8_t*>(vertexBuffer) + attributeOffset + static_cast<size_t>(first) * vertexStride);
+
+	float box[6];
+	VertexBounds range;
+	ispc::ComputeVertexBounds(positions, static_cast<int32_t>(vertexStride / sizeof(float)),
+		static_cast<int32_t>(count), box, range.sum);
+	for (int i = 0; i < 3; i++) {
+		range.minimum[i] = box[i];
+		range.maximum[i] = box[i + 3];
+	}
+	range.count = count;
+
+	bounds.Merge(range);
+}
+
+float My::MaxVertexDistance(const void* vertexBuffer, uint32_t vertexStride, uint32_t attributeOffset,
+	uint32_t vertexCount, const Vector3f& center)
+{
+	const float* positions = reinterpret_cast<const float*>(
+		static_cast<const uint8_t*>(vertexBuffer) + attributeOffset);
+
+	float distanceSq;
+	ispc::MaxDistanceSquared(positions, static_cast<int32_t>(vertexStride / sizeof(float)),
+		static_cast<int32_t>(vertexCount), center.data, &distanceSq);
+	return sqrtf(distanceSq);
+}
+
+namespace My {
+	// a bounds pass only reads positions; shorter ranges are not worth a thread
+	static const uint32_t kBoundsVerticesPerJob = 1 << 16;
+}
+
+void My::UpdateMeshBounds(SimpleMesh& mesh, bool exactSphere, uint32_t jobs)
+{
+	// every range of the split is at least kBoundsVerticesPerJob long, so
+	// first / kBoundsVerticesPerJob gives each its own slot; merging the
+	// slots in order keeps the centroid independent of thread timing
+	const uint8_t* vertices = static_cast<const uint8_t*>(mesh.m_vertexBuffer);
+	std::vector<VertexBounds> ranges(mesh.m_vertexCount / kBoundsVerticesPerJob + 1);
+	for (VertexBounds& range : ranges)
+		range.Reset();
+	ParallelFor(mesh.m_vertexCount, kBoundsVerticesPerJob, jobs, [&](uint32_t first, uint32_t last) {
+		AccumulateVertexBounds(vertices, mesh.m_vertexStride, 0, first, last - first,
+			ranges[first / kBoundsVerticesPerJob]);
+	});
+
+	VertexBounds bounds;
+	bounds.Reset();
+	for (const VertexBounds& range : ranges)
+		bounds.Merge(range);
+
+	AABB box = bounds.Box();
+	BoundingSphere sphere = bounds.Sphere();
+	if (exactSphere && bounds.count) {
+		std::vector<float> radii(ranges.size(), 0.0f);
+		ParallelFor(mesh.m_vertexCount, kBoundsVerticesPerJob, jobs, [&](uint32_t first, uint32_t last) {
+			radii[first / kBoundsVerticesPerJob] = MaxVertexDistance(
+				vertices + static_cast<size_t>(first) * mesh.m_vertexStride, mesh.m_vertexStride, 0,
+				last - first, sphere.center);
+		});
+		sphere.radius = *std::max_element(radii.begin(), radii.end());
+	}
+
+	for (int i = 0; i < 3; i++) {
+		mesh.m_boundsMin[i] = box.minimum[i];
+		mesh.m_boundsMax[i] = box.maximum[i];
+		mesh.m_boundingSphere[i] = sphere.center[i];
+	}
+	mesh.m_boundingSphere[3] = sphere.radius;
+}
+
+namespace My {
+	static_assert(sizeof(MeshVertex) == 48, "MeshVertex must be tightly packed");
+	static_assert(sizeof(PackedMeshVertex) == 24, "PackedMeshVertex must be tightly packed");
+
+	// strides of a vertex counted in 32, 16 and 8 bit units
+	template<typename V> struct VertexStrides
+	{
+		static const int32_t kFloats = sizeof(V) / sizeof(float);
+		static const int32_t kShorts = sizeof(V) / sizeof(int16_t);
+		static const int32_t kBytes  = sizeof(V);
+	};
+}
+
+bool My::PackMeshVertices(SimpleMesh& mesh)
+{
+	if (mesh.m_vertexStride != sizeof(MeshVertex))
+		return false;
+
+	typedef VertexStrides<MeshVertex> In;
+	typedef VertexStrides<PackedMeshVertex> Out;
+
+	const MeshVertex* in = static_cast<const MeshVertex*>(mesh.m_vertexBuffer);
+	uint32_t size = mesh.m_vertexCount * sizeof(PackedMeshVertex);
+	PackedMeshVertex* out = reinterpret_cast<PackedMeshVertex*>(new uint8_t[size]);
+	int32_t count = static_cast<int32_t>(mesh.m_vertexCount);
+
+	for (int32_t i = 0; i < count; i++) {
+		out[i].position[0] = in[i].position[0];
+		out[i].position[1] = in[i].position[1];
+		out[i].position[2] = in[i].position[2];
+		out[i].tangent[3] = 0;
+	}
+	ispc::EncodeOctahedral16(in->normal, In::kFloats, out->normal, Out::kShorts, count);
+	ispc::EncodeOctahedral8(in->tangent, In::kFloats, out->tangent, Out::kBytes, count);
+	ispc::FloatToSnorm8(in->tangent + 3, In::kFloats, out->tangent + 2, Out::kBytes, 1, count);
+	ispc::FloatToHalf(in->uv, In::kFloats, out->uv, Out::kShorts, 2, count);
+
+	delete[] static_cast<uint8_t*>(mesh.m_vertexBuffer);
+	mesh.m_vertexBuffer = out;
+	mesh.m_vertexStride = sizeof(PackedMeshVertex);
+	mesh.m_vertexBufferSize = size;
+	return true;
+}
+
+bool My::UnpackMeshVertices(SimpleMesh& mesh)
+{
+	if (mesh.m_vertexStride != sizeof(PackedMeshVertex))
+		return false;
+
+	typedef VertexStrides<PackedMeshVertex> In;
+	typedef VertexStrides<MeshVertex> Out;
+
+	const PackedMeshVertex* in = static_cast<const PackedMeshVertex*>(mesh.m_vertexBuffer);
+	uint32_t size = mesh.m_vertexCount * sizeof(MeshVertex);
+	MeshVertex* out = reinterpret_cast<MeshVertex*>(new uint8_t[size]);
+	int32_t count = static_cast<int32_t>(mesh.m_vertexCount);
+
+	for (int32_t i = 0; i < count; i++) {
+		out[i].position[0] = in[i].position[0];
+		out[i].position[1] = in[i].position[1];
+		out[i].position[2] = in[i].position[2];
+	}
+	ispc::DecodeOctahedral16(in->normal, In::kShorts, out->normal, Out::kFloats, count);
+	ispc::DecodeOctahedral8(in->tangent, In::kBytes, out->tangent, Out::kFloats, count);
+	ispc::Snorm8ToFloat(in->tangent + 2, In::kBytes, out->tangent + 3, Out::kFloats, 1, count);
+	ispc::HalfToFloat(in->uv, In::kShorts, out->uv, Out::kFloats, 2, count);
+
+	delete[] static_cast<uint8_t*>(mesh.m_vertexBuffer);
+	mesh.m_vertexBuffer = out;
+	mesh.m_vertexStride = sizeof(MeshVertex);
+	mesh.m_vertexBufferSize = size;
+	return true;
+}
+
+bool My::IntersectRayMesh(const SimpleMesh& mesh, const Vector3f& origin, const Vector3f& direction,
+	float tMax, RayHit& hit)
+{
+	const float* vertices = static_cast<const float*>(mesh.m_vertexBuffer);
+	int32_t stride = static_cast<int32_t>(mesh.m_vertexStride / sizeof(float));
+	int32_t triangleCount = static_cast<int32_t>(mesh.m_indexCount / 3);
+
+	int32_t triangle;
+	if (mesh.m_indexType == kIndexSize16) {
+		triangle = ispc::IntersectRayTriangles16(origin.data, direction.data, tMax, vertices, stride,
+			static_cast<const uint16_t*>(mesh.m_indexBuffer), triangleCount, &hit.t, &hit.u, &hit.v);
+	} else {
+		triangle = ispc::IntersectRayTriangles32(origin.data, direction.data, tMax, vertices, stride,
+			static_cast<const uint32_t*>(mesh.m_indexBuffer), triangleCount, &hit.t, &hit.u, &hit.v);
+	}
+
+	if (triangle < 0)
+		return false;
+
+	hit.triangle = static_cast<uint32_t>(triangle);
+	return true;
+}
+
+void My::IntersectRaysMesh(const SimpleMesh& mesh,
+	const float* ox, const float* oy, const float* oz,
+	const float* dx, const float* dy, const float* dz,
+	float* tHit, int32_t* hitTriangle, float* hitU, float* hitV, uint32_t rayCount)
+{
+	const float* vertices = static_cast<const float*>(mesh.m_vertexBuffer);
+	int32_t stride = static_cast<int32_t>(mesh.m_vertexStride / sizeof(float));
+	int32_t triangleCount = static_cast<int32_t>(mesh.m_indexCount / 3);
+
+	if (mesh.m_indexType == kIndexSize16) {
+		ispc::IntersectRaysTriangles16(vertices, stride, static_cast<const uint16_t*>(mesh.m_indexBuffer), triangleCount,
+			ox, oy, oz, dx, dy, dz, tHit, hitTriangle, hitU, hitV, static_cast<int32_t>(rayCount));
+	} else {
+		ispc::IntersectRaysTriangles32(vertices, stride, static_cast<const uint32_t*>(mesh.m_indexBuffer), triangleCount,
+			ox, oy, oz, dx, dy, dz, tHit, hitTriangle, hitU, hitV, static_cast<int32_t>(rayCount));
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "Mesh.h"
+#include "geommath.hpp"
+
+namespace My {
+	// Helpers running the GeomMath kernels over SimpleMesh buffers. Meshes
+	// are triangle lists whose vertices start with a float3 position, and
+	// m_vertexStride is a multiple of 4 bytes.
+
+	/// Full precision vertex, the layout written by the mesh builders.
+	struct MeshVertex
+	{
+		float position[3];
+		float normal[3];
+		float tangent[4];    ///< xyz, handedness in w
+		float uv[2];
+	};
+
+	/// MeshVertex in half the size. Normals are octahedral snorm16, tangents
+	/// octahedral snorm8 with the handedness in tangent[2], uvs are halves,
+	/// which keeps texel accuracy for coordinates within a few repeats.
+	struct PackedMeshVertex
+	{
+		float    position[3];
+		int16_t  normal[2];
+		int8_t   tangent[4];
+		uint16_t uv[2];
+	};
+
+	/// Partial result of a bounds pass. Large buffers can be split into
+	/// ranges, one AccumulateVertexBounds() per job, and merged afterwards.
+	struct VertexBounds
+	{
+		float    minimum[3];
+		float    maximum[3];
+		double   sum[3];     ///< for the centroid
+		uint32_t count;
+
+		void Reset();
+		void Merge(const VertexBounds& other);
+		Vector3f Centroid() const;
+		AABB     Box() const;
+		/// Sphere around the box center with half the diagonal as radius;
+		/// conservative, and needs no second pass over the vertices.
+		BoundingSphere Sphere() const;
+	};
+
+	struct RayHit
+	{
+		float    t;          ///< distance in units of the ray direction
+		float    u, v;       ///< barycentrics of the hit point
+		uint32_t triangle;
+	};
+
+	/// Adds vertices [first, first + count) of an interleaved buffer to
+	/// 'bounds'. Strides and offsets are in bytes and must be multiples of 4;
+	/// attributeOffset locates the float3 position inside a vertex.
+	void AccumulateVertexBounds(const void* vertexBuffer, uint32_t vertexStride, uint32_t attributeOffset,
+		uint32_t first, uint32_t count, VertexBounds& bounds);
+
+	/// Radius of the tightest sphere around 'center' containing every position.
+	float MaxVertexDistance(const void* vertexBuffer, uint32_t vertexStride, uint32_t attributeOffset,
+		uint32_t vertexCount, const Vector3f& center);
+
+	/// Fills m_boundsMin/m_boundsMax/m_boundingSphere in one pass. With
+	/// exactSphere the radius is tightened around the box center at the cost
+	/// of a second pass. Large meshes are split across 'jobs' threads (0: one
+	/// per hardware thread), ranges merged with VertexBounds::Merge().
+	void UpdateMeshBounds(SimpleMesh& mesh, bool exactSphere = false, uint32_t jobs = 0);
+
+	/// Converts a mesh of MeshVertex to PackedMeshVertex, or back. The
+	/// vertex buffer is replaced by one allocated with new uint8_t[] (the old
+	/// one is released with delete[]), and m_vertexStride and
+	/// m_vertexBufferSize are updated. Returns false, leaving the mesh
+	/// alone, when it is not in the source layout.
+	bool PackMeshVertices(SimpleMesh& mesh);
+	bool UnpackMeshVertices(SimpleMesh& mesh);
+
+	/// Closest triangle hit by the ray before tMax. Returns false on a miss.
+	bool IntersectRayMesh(const SimpleMesh& mesh, const Vector3f& origin, const Vector3f& direction,
+		float tMax, RayHit& hit);
+
+	/// Packet form: tHit[i] is in/out and must start at the maximum distance;
+	/// hitTriangle[i] and tHit[i] are only updated when a closer hit is found.
+	void IntersectRaysMesh(const SimpleMesh& mesh,
+		const float* ox, const float* oy, const float* oz,
+		const float* dx, const float* dy, const float* dz,
+		float* tHit, int32_t* hitTriangle, float* hitU, float* hitV, uint32_t rayCount);
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace My {
+	/// Runs f(first, last) over [0, count) split into contiguous ranges of
+	/// at least minBatch items, each on its own thread, with up to 'jobs'
+	/// threads (0: one per hardware thread). The calling thread takes the
+	/// first range and the call returns when every range is done, so f may
+	/// capture locals by reference. f is called concurrently and must only
+	/// write the outputs of its own range.
+	template<typename F>
+	void ParallelFor(uint32_t count, uint32_t minBatch, uint32_t jobs, const F& f)
+	{
+		if (!count)
+			return;
+
+		if (!jobs)
+			jobs = std::max(1u, std::thread::hardware_concurrency());
+		jobs = std::min(jobs, std::max(1u, count / std::max(1u, minBatch)));
+
+		if (jobs == 1) {
+			f(0u, count);
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		threads.reserve(jobs - 1);
+		for (uint32_t j = 1; j < jobs; j++) {
+			uint32_t first = static_cast<uint32_t>(uint64_t(count) * j / jobs);
+			uint32_t last = static_cast<uint32_t>(uint64_t(count) * (j + 1) / jobs);
+			threads.emplace_back([&f, first, last]() { f(first, last); });
+		}
+		f(0u, static_cast<uint32_t>(count / jobs));
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+}
@@ -0,0 +1,293 @@
+#include <math.h>
+#include <vector>
+#include "ProceduralMesh.hpp"
+#include "MeshUtility.hpp"
+#include "Parallel.hpp"
+
+using namespace My;
+
+namespace {
+	const float kPi = 3.14159265358979323846f;
+
+	// rows are split so that every job builds at least this many vertices
+	const uint32_t kVerticesPerJob = 4096;
+
+	/// One row of a surface of revolution: a point of the profile in the
+	/// (distance from the axis, height) plane with its outward normal.
+	struct ProfileRow
+	{
+		float r, y;
+		float nr, ny;
+		bool  joined;    ///< quads connect this row to the previous one
+	};
+
+	uint32_t RowsPerJob(uint32_t columns)
+	{
+		return std::max(1u, kVerticesPerJob / columns);
+	}
+
+	// Quads (row, c) (row, c + 1) (row + 1, c) (row + 1, c + 1) are split
+	// along the same diagonal everywhere. A row collapsed to a point (a
+	// pole or a cap center) drops the triangle that has an edge on it.
+	template<typename Index>
+	void WriteQuadRow(Index* out, uint32_t row, uint32_t columns, bool lowerCollapsed, bool upperCollapsed)
+	{
+		for (uint32_t c = 0; c + 1 < columns; c++) {
+			uint32_t a = row * columns + c;
+			uint32_t b = a + 1;
+			uint32_t above = a + columns;
+			if (!lowerCollapsed) {
+				out[0] = static_cast<Index>(a);
+				out[1] = static_cast<Index>(above);
+				out[2] = static_cast<Index>(b);
+				out += 3;
+			}
+			if (!upperCollapsed) {
+				out[0] = static_cast<Index>(b);
+				out[1] = static_cast<Index>(above);
+				out[2] = static_cast<Index>(above + 1);
+				out += 3;
+			}
+		}
+	}
+
+	/// Index buffer of 'rows' rows of 'columns' vertices. joined[i] tells
+	/// whether quads connect row i - 1 to row i, collapsed[i] whether row i
+	/// is a single point.
+	void BuildRowIndices(SimpleMesh& mesh, uint32_t rows, uint32_t columns,
+		const std::vector<bool>& joined, const std::vector<bool>& collapsed, uint32_t jobs)
+	{
+		// first index of every quad row
+		std::vector<uint32_t> offsets(rows, 0);
+		for (uint32_t row = 0; row + 1 < rows; row++) {
+			uint32_t triangles = 0;
+			if (joined[row + 1])
+				triangles = (columns - 1) * ((collapsed[row] ? 0 : 1) + (collapsed[row + 1] ? 0 : 1));
+			offsets[row + 1] = offsets[row] + triangles * 3;
+		}
+
+		uint32_t vertexCount = rows * columns;
+		mesh.m_indexCount = offsets[rows - 1];
+		mesh.m_indexType = vertexCount <= 0x10000 ? kIndexSize16 : kIndexSize32;
+		mesh.m_indexBufferSize = mesh.m_indexCount * (mesh.m_indexType == kIndexSize16 ? sizeof(uint16_t) : sizeof(uint32_t));
+		mesh.m_indexBuffer = new uint8_t[mesh.m_indexBufferSize];
+
+		void* indices = mesh.m_indexBuffer;
+		bool use16 = mesh.m_indexType == kIndexSize16;
+		ParallelFor(rows - 1, RowsPerJob(columns), jobs, [&](uint32_t first, uint32_t last) {
+			for (uint32_t row = first; row < last; row++) {
+				if (!joined[row + 1])
+					continue;
+				if (use16)
+					WriteQuadRow(static_cast<uint16_t*>(indices) + offsets[row], row, columns, collapsed[row], collapsed[row + 1]);
+				else
+					WriteQuadRow(static_cast<uint32_t*>(indices) + offsets[row], row, columns, collapsed[row], collapsed[row + 1]);
+			}
+		});
+	}
+
+	void ReleaseMeshBuffers(SimpleMesh& mesh)
+	{
+		delete[] static_cast<uint8_t*>(mesh.m_vertexBuffer);
+		delete[] static_cast<uint8_t*>(mesh.m_indexBuffer);
+		mesh.m_vertexBuffer = nullptr;
+		mesh.m_indexBuffer = nullptr;
+	}
+
+	MeshVertex* AllocateVertices(SimpleMesh& mesh, uint32_t vertexCount)
+	{
+		ReleaseMeshBuffers(mesh);
+		mesh.m_vertexCount = vertexCount;
+		mesh.m_vertexStride = sizeof(MeshVertex);
+		mesh.m_vertexAttributeCount = 4;    // position, normal, tangent, uv
+		mesh.m_vertexBufferSize = vertexCount * sizeof(MeshVertex);
+		mesh.m_vertexBuffer = new uint8_t[mesh.m_vertexBufferSize];
+		mesh.m_primitiveType = kPrimitiveTypeTriList;
+		return static_cast<MeshVertex*>(mesh.m_vertexBuffer);
+	}
+
+	/// Revolves the profile about +Y in 'segments' steps. v follows the arc
+	/// length of the profile, scaled to vRepeats.
+	void BuildRevolution(SimpleMesh& mesh, const std::vector<ProfileRow>& profile, uint32_t segments,
+		float uRepeats, float vRepeats, uint32_t jobs)
+	{
+		uint32_t rows = static_cast<uint32_t>(profile.size());
+		uint32_t columns = segments + 1;
+
+		std::vector<float> v(rows, 0.0f);
+		for (uint32_t row = 1; row < rows; row++) {
+			float dr = profile[row].r - profile[row - 1].r;
+			float dy = profile[row].y - profile[row - 1].y;
+			v[row] = v[row - 1] + (profile[row].joined ? sqrtf(dr * dr + dy * dy) : 0.0f);
+		}
+		float vScale = v[rows - 1] > 0.0f ? vRepeats / v[rows - 1] : 0.0f;
+
+		// the last column repeats the first exactly, so the seam is closed
+		std::vector<float> cosines(columns), sines(columns);
+		for (uint32_t c = 0; c < segments; c++) {
+			float phi = 2.0f * kPi * c / segments;
+			cosines[c] = cosf(phi);
+			sines[c] = sinf(phi);
+		}
+		cosines[segments] = cosines[0];
+		sines[segments] = sines[0];
+
+		MeshVertex* vertices = AllocateVertices(mesh, rows * columns);
+		float uScale = uRepeats / segments;
+
+		ParallelFor(rows, RowsPerJob(columns), jobs, [&](uint32_t first, uint32_t last) {
+			for (uint32_t row = first; row < last; row++) {
+				const ProfileRow& p = profile[row];
+				float rowV = v[row] * vScale;
+				MeshVertex* out = vertices + row * columns;
+				for (uint32_t c = 0; c < columns; c++, out++) {
+					float cs = cosines[c], sn = sines[c];
+					out->position[0] = p.r * cs;
+					out->position[1] = p.y;
+					out->position[2] = p.r * sn;
+					out->normal[0] = p.nr * cs;
+					out->normal[1] = p.ny;
+					out->normal[2] = p.nr * sn;
+					out->tangent[0] = -sn;
+					out->tangent[1] = 0.0f;
+					out->tangent[2] = cs;
+					out->tangent[3] = -1.0f;
+					out->uv[0] = c * uScale;
+					out->uv[1] = rowV;
+				}
+			}
+		});
+
+		std::vector<bool> joined(rows), collapsed(rows);
+		for (uint32_t row = 0; row < rows; row++) {
+			joined[row] = profile[row].joined;
+			collapsed[row] = profile[row].r == 0.0f;
+		}
+		BuildRowIndices(mesh, rows, columns, joined, collapsed, jobs);
+		UpdateMeshBounds(mesh, false, jobs);
+	}
+
+	ProfileRow MakeRow(float r, float y, float nr, float ny, bool joined = true)
+	{
+		ProfileRow row = { r, y, nr, ny, joined };
+		return row;
+	}
+}
+
+bool My::BuildTorusMesh(SimpleMesh& mesh, float outerRadius, float innerRadius,
+	uint32_t outerQuads, uint32_t innerQuads, float outerRepeats, float innerRepeats, uint32_t jobs)
+{
+	if (outerQuads < 3 || innerQuads < 3)
+		return false;
+
+	// the tube's cross section, counterclockwise from the outer equator
+	std::vector<ProfileRow> profile(innerQuads + 1);
+	for (uint32_t i = 0; i < innerQuads; i++) {
+		float psi = 2.0f * kPi * i / innerQuads;
+		float c = cosf(psi), s = sinf(psi);
+		profile[i] = MakeRow(outerRadius + innerRadius * c, innerRadius * s, c, s, i > 0);
+	}
+	profile[innerQuads] = profile[0];
+	profile[innerQuads].joined = true;
+
+	BuildRevolution(mesh, profile, outerQuads, outerRepeats, innerRepeats, jobs);
+	return true;
+}
+
+bool My::BuildSphereMesh(SimpleMesh& mesh, float radius, uint32_t rings, uint32_t segments, uint32_t jobs)
+{
+	if (rings < 2 || segments < 3)
+		return false;
+
+	std::vector<ProfileRow> profile(rings + 1);
+	for (uint32_t i = 0; i <= rings; i++) {
+		float theta = kPi * i / rings;
+		float s = (i == 0 || i == rings) ? 0.0f : sinf(theta);
+		float c = cosf(theta);
+		profile[i] = MakeRow(radius * s, -radius * c, s, -c, i > 0);
+	}
+
+	BuildRevolution(mesh, profile, segments, 1.0f, 1.0f, jobs);
+	return true;
+}
+
+bool My::BuildCapsuleMesh(SimpleMesh& mesh, float radius, float height, uint32_t rings, uint32_t segments, uint32_t jobs)
+{
+	if (rings < 1 || segments < 3 || height < 0.0f)
+		return false;
+
+	// two hemispheres; the body is the quad row between their equators
+	std::vector<ProfileRow> profile;
+	profile.reserve(2 * (rings + 1));
+	for (uint32_t hemisphere = 0; hemisphere < 2; hemisphere++) {
+		float center = hemisphere ? 0.5f * height : -0.5f * height;
+		for (uint32_t i = 0; i <= rings; i++) {
+			uint32_t step = hemisphere * rings + i;
+			float theta = 0.5f * kPi * step / rings;
+			float s = (step == 0 || step == 2 * rings) ? 0.0f : sinf(theta);
+			float c = (step == rings) ? 0.0f : cosf(theta);
+			bool joined = i > 0 || (hemisphere && height > 0.0f);
+			profile.push_back(MakeRow(radius * s, center - radius * c, s, -c, joined));
+		}
+	}
+
+	BuildRevolution(mesh, profile, segments, 1.0f, 1.0f, jobs);
+	return true;
+}
+
+bool My::BuildCylinderMesh(SimpleMesh& mesh, float radius, float height, uint32_t heightQuads, uint32_t segments, uint32_t jobs)
+{
+	if (heightQuads < 1 || segments < 3)
+		return false;
+
+	float bottom = -0.5f * height, top = 0.5f * height;
+	std::vector<ProfileRow> profile;
+	profile.reserve(heightQuads + 5);
+	profile.push_back(MakeRow(0.0f, bottom, 0.0f, -1.0f, false));
+	profile.push_back(MakeRow(radius, bottom, 0.0f, -1.0f));
+	for (uint32_t i = 0; i <= heightQuads; i++)
+		profile.push_back(MakeRow(radius, bottom + height * i / heightQuads, 1.0f, 0.0f, i > 0));
+	profile.push_back(MakeRow(radius, top, 0.0f, 1.0f, false));
+	profile.push_back(MakeRow(0.0f, top, 0.0f, 1.0f));
+
+	BuildRevolution(mesh, profile, segments, 1.0f, 1.0f, jobs);
+	return true;
+}
+
+bool My::BuildGridMesh(SimpleMesh& mesh, float width, float depth, uint32_t widthQuads, uint32_t depthQuads, uint32_t jobs)
+{
+	if (widthQuads < 1 || depthQuads < 1)
+		return false;
+
+	uint32_t rows = depthQuads + 1;
+	uint32_t columns = widthQuads + 1;
+	MeshVertex* vertices = AllocateVertices(mesh, rows * columns);
+
+	float dx = width / widthQuads, dz = depth / depthQuads;
+	float du = 1.0f / widthQuads, dv = 1.0f / depthQuads;
+	ParallelFor(rows, RowsPerJob(columns), jobs, [&](uint32_t first, uint32_t last) {
+		for (uint32_t row = first; row < last; row++) {
+			MeshVertex* out = vertices + row * columns;
+			for (uint32_t c = 0; c < columns; c++, out++) {
+				out->position[0] = -0.5f * width + c * dx;
+				out->position[1] = 0.0f;
+				out->position[2] = -0.5f * depth + row * dz;
+				out->normal[0] = 0.0f;
+				out->normal[1] = 1.0f;
+				out->normal[2] = 0.0f;
+				out->tangent[0] = 1.0f;
+				out->tangent[1] = 0.0f;
+				out->tangent[2] = 0.0f;
+				out->tangent[3] = -1.0f;
+				out->uv[0] = c * du;
+				out->uv[1] = row * dv;
+			}
+		}
+	});
+
+	std::vector<bool> joined(rows, true), collapsed(rows, false);
+	joined[0] = false;
+	BuildRowIndices(mesh, rows, columns, joined, collapsed, jobs);
+	UpdateMeshBounds(mesh, false, jobs);
+	return true;
+}
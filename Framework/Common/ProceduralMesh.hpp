@@ -0,0 +1,48 @@
+#pragma once
+#include "Mesh.h"
+
+namespace My {
+	// Procedural shapes built as SimpleMesh triangle lists of MeshVertex,
+	// ready for the MeshUtility passes. Every shape is a grid of vertex rows:
+	// the grid lies in the XZ plane, the others are surfaces of revolution
+	// about +Y, with rows going up the profile and 'segments' quads around.
+	// The first and last column share positions so texture coordinates can
+	// wrap. Rows are computed in closed form from per-row and per-column
+	// sines and cosines and split across 'jobs' threads (0: one per
+	// hardware thread).
+	//
+	// Front faces are clockwise, as in Direct3D. Tangents point along +u;
+	// the bitangent cross(normal, tangent) * tangent.w points along +v.
+	// Indices are 16-bit when the vertex count allows it. Buffers already in
+	// the mesh are released with delete[], the new ones are allocated with
+	// new uint8_t[], and the bounds are filled in by UpdateMeshBounds().
+	// The builders return false, leaving the mesh alone, when the
+	// tessellation is too coarse for the shape.
+
+	/// Ring of 'outerQuads' x 'innerQuads' quads around +Y. The texture
+	/// repeats outerRepeats times around the ring and innerRepeats times
+	/// around the tube.
+	bool BuildTorusMesh(SimpleMesh& mesh, float outerRadius, float innerRadius,
+		uint32_t outerQuads, uint32_t innerQuads, float outerRepeats = 1.0f, float innerRepeats = 1.0f,
+		uint32_t jobs = 0);
+
+	/// UV sphere of 'rings' rows from pole to pole; the poles are single
+	/// triangle fans, without degenerate triangles.
+	bool BuildSphereMesh(SimpleMesh& mesh, float radius, uint32_t rings, uint32_t segments,
+		uint32_t jobs = 0);
+
+	/// Cylinder of 'height' between the centers of two hemispheres of
+	/// 'rings' rows each; the total height is height + 2 * radius.
+	bool BuildCapsuleMesh(SimpleMesh& mesh, float radius, float height, uint32_t rings, uint32_t segments,
+		uint32_t jobs = 0);
+
+	/// Closed cylinder centered on the origin; the caps have their own
+	/// vertices so the rim keeps a hard edge.
+	bool BuildCylinderMesh(SimpleMesh& mesh, float radius, float height, uint32_t heightQuads, uint32_t segments,
+		uint32_t jobs = 0);
+
+	/// Plane of width (x) by depth (z) centered on the origin, facing +Y,
+	/// with the texture stretched once over it.
+	bool BuildGridMesh(SimpleMesh& mesh, float width, float depth, uint32_t widthQuads, uint32_t depthQuads,
+		uint32_t jobs = 0);
+}
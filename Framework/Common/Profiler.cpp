@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "Logger.hpp"
+#include "Profiler.hpp"
+
+using namespace My;
+
+namespace My {
+	// upper bound of raw samples kept for trace export (32 bytes each)
+	static const size_t kMaxCapturedSamples = 1 << 20;
+
+	std::atomic<ProfileBuffer*> Profiler::s_pBufferList(nullptr);
+	std::atomic<uint32_t>       Profiler::s_nThreadCount(0);
+
+	static thread_local ProfileBuffer* t_pProfileBuffer = nullptr;
+}
+
+size_t My::ProfileBuffer::Drain(std::vector<ProfileSample>& out)
+{
+	uint32_t tail = m_tail.load(std::memory_order_relaxed);
+	uint32_t head = m_head.load(std::memory_order_acquire);
+
+	for (uint32_t i = tail; i != head; i++) {
+		out.push_back(m_samples[i & (kCapacity - 1)]);
+	}
+
+	m_tail.store(head, std::memory_order_release);
+	return head - tail;
+}
+
+My::Profiler::Profiler()
+	: m_nFrameCount(0), m_nFrameBegin(0), m_nCaptureBase(0),
+	m_bCapture(false), m_TracePath(nullptr)
+{
+}
+
+int My::Profiler::Initialize()
+{
+	m_nFrameCount = 0;
+	m_nFrameBegin = Now();
+	m_nCaptureBase = m_nFrameBegin;
+	m_Pending.reserve(ProfileBuffer::kCapacity);
+
+	// discard anything recorded before the profiler was up
+	for (ProfileBuffer* p = s_pBufferList.load(std::memory_order_acquire); p; p = p->m_pNext) {
+		p->Drain(m_Pending);
+	}
+	m_Pending.clear();
+
+	return 0;
+}
+
+void My::Profiler::Finalize()
+{
+	if (m_TracePath) {
+		if (!ExportChromeTrace(m_TracePath)) {
+			LOG_ERROR("Profiler: failed to write trace to %s", m_TracePath);
+		}
+	}
+
+	m_Captured.clear();
+	m_Captured.shrink_to_fit();
+}
+
+void My::Profiler::Tick()
+{
+	uint64_t now = Now();
+
+	m_Pending.clear();
+	for (ProfileBuffer* p = s_pBufferList.load(std::memory_order_acquire); p; p = p->m_pNext) {
+		p->Drain(m_Pending);
+	}
+
+	ProfileFrame& frame = m_Frames[m_nFrameCount % kFrameHistory];
+	frame.frameIndex = m_nFrameCount;
+	frame.begin = m_nFrameBegin;
+	frame.end = now;
+
+	if (m_bCapture && m_Captured.size() < kMaxCapturedSamples) {
+		size_t room = kMaxCapturedSamples - m_Captured.size();
+		size_t count = std::min(room, m_Pending.size());
+		m_Captured.insert(m_Captured.end(), m_Pending.begin(), m_Pending.begin() + count);
+	}
+
+	BuildHierarchy(frame, m_Pending);
+
+	m_nFrameBegin = now;
+	++m_nFrameCount;
+}
+
+uint64_t My::Profiler::Now()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+ProfileBuffer* My::Profiler::GetThreadBuffer()
+{
+	ProfileBuffer* pBuffer = t_pProfileBuffer;
+	if (!pBuffer) {
+		// first scope on this thread: publish a new buffer with a CAS push,
+		// buffers live until process exit so the list is never unlinked
+		pBuffer = new ProfileBuffer(s_nThreadCount.fetch_add(1, std::memory_order_relaxed));
+		ProfileBuffer* pHead = s_pBufferList.load(std::memory_order_relaxed);
+		do {
+			pBuffer->m_pNext = pHead;
+		} while (!s_pBufferList.compare_exchange_weak(pHead, pBuffer,
+			std::memory_order_release, std::memory_order_relaxed));
+		t_pProfileBuffer = pBuffer;
+	}
+
+	return pBuffer;
+}
+
+const ProfileFrame* My::Profiler::GetLastFrame() const
+{
+	return GetFrame(0);
+}
+
+const ProfileFrame* My::Profiler::GetFrame(uint32_t age) const
+{
+	if (age >= kFrameHistory || age >= m_nFrameCount)
+		return nullptr;
+
+	return &m_Frames[(m_nFrameCount - 1 - age) % kFrameHistory];
+}
+
+void My::Profiler::BuildHierarchy(ProfileFrame& frame, std::vector<ProfileSample>& samples)
+{
+	frame.nodes.clear();
+
+	// children are written before their parents (a scope is recorded when it
+	// closes), so restore begin order per thread before walking the tree
+	std::sort(samples.begin(), samples.end(), [](const ProfileSample& a, const ProfileSample& b) {
+		if (a.threadId != b.threadId) return a.threadId < b.threadId;
+		if (a.begin != b.begin) return a.begin < b.begin;
+		return a.depth < b.depth;
+	});
+
+	struct OpenScope { int32_t node; uint32_t depth; uint64_t end; };
+	std::vector<OpenScope> stack;
+	uint32_t thread = UINT32_MAX;
+
+	for (const ProfileSample& s : samples) {
+		if (s.threadId != thread) {
+			stack.clear();
+			thread = s.threadId;
+		}
+
+		while (!stack.empty() && (stack.back().depth >= s.depth || stack.back().end < s.end)) {
+			stack.pop_back();
+		}
+
+		int32_t parent = stack.empty() ? -1 : stack.back().node;
+		int32_t node = -1;
+		for (int32_t i = parent + 1; i < static_cast<int32_t>(frame.nodes.size()); i++) {
+			const ProfileNode& n = frame.nodes[i];
+			if (n.parent == parent && n.threadId == thread && n.name == s.name) {
+				node = i;
+				break;
+			}
+		}
+
+		if (node < 0) {
+			ProfileNode n;
+			n.name = s.name;
+			n.parent = parent;
+			n.depth = stack.empty() ? 0 : frame.nodes[parent].depth + 1;
+			n.threadId = thread;
+			n.callCount = 0;
+			n.inclusiveTime = 0;
+			n.exclusiveTime = 0;
+			node = static_cast<int32_t>(frame.nodes.size());
+			frame.nodes.push_back(n);
+		}
+
+		uint64_t duration = s.end - s.begin;
+		frame.nodes[node].callCount++;
+		frame.nodes[node].inclusiveTime += duration;
+		frame.nodes[node].exclusiveTime += duration;
+		if (parent >= 0) {
+			frame.nodes[parent].exclusiveTime -= duration;
+		}
+
+		stack.push_back({ node, s.depth, s.end });
+	}
+}
+
+bool My::Profiler::ExportChromeTrace(const char* path) const
+{
+	FILE* fp = fopen(path, "w");
+	if (!fp)
+		return false;
+
+	fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	uint32_t threads = s_nThreadCount.load(std::memory_order_relaxed);
+	for (uint32_t t = 0; t < threads; t++) {
+		fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}",
+			t ? ",\n" : "", t, t);
+	}
+
+	bool first = (threads == 0);
+	for (const ProfileSample& s : m_Captured) {
+		if (!first) fputs(",\n", fp);
+		first = false;
+
+		fputs("{\"name\":\"", fp);
+		for (const char* c = s.name; *c; c++) {
+			if (*c == '"' || *c == '\\') fputc('\\', fp);
+			fputc(*c, fp);
+		}
+		// timestamps are microseconds relative to the start of capture
+		fprintf(fp, "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+			s.threadId,
+			(s.begin - m_nCaptureBase) / 1000.0,
+			(s.end - s.begin) / 1000.0);
+	}
+
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+
+	return true;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "IRuntimeModule.hpp"
+
+namespace My
+{
+	/// One closed profiling scope as written by the instrumented thread.
+	struct ProfileSample
+	{
+		const char* name;   ///< static string, never copied
+		uint64_t begin;     ///< nanoseconds, Profiler::Now() clock
+		uint64_t end;       ///< nanoseconds, Profiler::Now() clock
+		uint32_t depth;     ///< nesting depth on the recording thread
+		uint32_t threadId;  ///< profiler-assigned thread index
+	};
+
+	/// Aggregated node of a per-frame scope hierarchy.
+	struct ProfileNode
+	{
+		const char* name;
+		int32_t  parent;        ///< index into ProfileFrame::nodes, -1 for roots
+		uint32_t depth;
+		uint32_t threadId;
+		uint32_t callCount;
+		uint64_t inclusiveTime; ///< nanoseconds
+		uint64_t exclusiveTime; ///< nanoseconds
+	};
+
+	struct ProfileFrame
+	{
+		uint64_t frameIndex;
+		uint64_t begin;
+		uint64_t end;
+		std::vector<ProfileNode> nodes;
+	};
+
+	/// Single-producer/single-consumer ring owned by one instrumented thread.
+	/// The owning thread only ever advances m_head, the profiler only ever
+	/// advances m_tail, so neither side takes a lock. When the ring is full
+	/// new samples are dropped instead of blocking the producer.
+	class ProfileBuffer
+	{
+	public:
+		static const uint32_t kCapacity = 1 << 14;
+
+		ProfileBuffer(uint32_t threadId)
+			: m_head(0), m_tail(0), m_dropped(0), m_depth(0),
+			m_threadId(threadId), m_pNext(nullptr) {};
+
+		inline uint32_t Enter() { return m_depth++; };
+
+		inline void Leave(const char* name, uint64_t begin, uint64_t end, uint32_t depth)
+		{
+			m_depth = depth;
+			uint32_t head = m_head.load(std::memory_order_relaxed);
+			if (head - m_tail.load(std::memory_order_acquire) >= kCapacity) {
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			ProfileSample& sample = m_samples[head & (kCapacity - 1)];
+			sample.name = name;
+			sample.begin = begin;
+			sample.end = end;
+			sample.depth = depth;
+			sample.threadId = m_threadId;
+			m_head.store(head + 1, std::memory_order_release);
+		}
+
+		/// Consumer side: move every pending sample into out.
+		size_t Drain(std::vector<ProfileSample>& out);
+
+		inline uint32_t GetThreadId() const { return m_threadId; };
+		inline uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); };
+
+	private:
+		ProfileSample m_samples[kCapacity];
+		// producer and consumer indices live on separate cache lines
+		std::atomic<uint32_t> m_head;
+		uint8_t m_padding[60];
+		std::atomic<uint32_t> m_tail;
+		std::atomic<uint64_t> m_dropped;
+		uint32_t m_depth;
+		uint32_t m_threadId;
+
+		ProfileBuffer* m_pNext;
+		friend class Profiler;
+	};
+
+	class Profiler : implements IRuntimeModule
+	{
+	public:
+		static const uint32_t kFrameHistory = 256;
+
+		Profiler();
+		virtual ~Profiler() {}
+
+		virtual int Initialize();
+		virtual void Finalize();
+
+		/// Marks a frame boundary: drains every thread buffer and builds the
+		/// hierarchy for the frame that just ended. Call outside any scope.
+		virtual void Tick();
+
+		/// Monotonic timestamp in nanoseconds.
+		static uint64_t Now();
+
+		/// Buffer of the calling thread, registered on first use.
+		static ProfileBuffer* GetThreadBuffer();
+
+		/// Keep raw samples of every frame for trace export (off by default).
+		void SetCaptureEnabled(bool enabled) { m_bCapture = enabled; };
+		/// If set, the capture is written as a Chrome trace on Finalize().
+		void SetTraceOutput(const char* path) { m_TracePath = path; m_bCapture = (path != nullptr); };
+
+		/// Writes captured samples in Chrome Trace Event JSON, which both
+		/// chrome://tracing and Perfetto load directly.
+		bool ExportChromeTrace(const char* path) const;
+
+		/// Most recent completed frame, nullptr before the first Tick().
+		const ProfileFrame* GetLastFrame() const;
+		/// Completed frame 'age' frames ago (0 == last), nullptr if evicted.
+		const ProfileFrame* GetFrame(uint32_t age) const;
+
+		inline uint64_t GetFrameCount() const { return m_nFrameCount; };
+
+	private:
+		void BuildHierarchy(ProfileFrame& frame, std::vector<ProfileSample>& samples);
+
+	private:
+		static std::atomic<ProfileBuffer*> s_pBufferList;
+		static std::atomic<uint32_t> s_nThreadCount;
+
+		ProfileFrame m_Frames[kFrameHistory];
+		uint64_t m_nFrameCount;
+		uint64_t m_nFrameBegin;
+		uint64_t m_nCaptureBase;
+
+		std::vector<ProfileSample> m_Pending;
+		std::vector<ProfileSample> m_Captured;
+		bool m_bCapture;
+		const char* m_TracePath;
+	};
+
+	/// RAII marker, use through PROFILE_SCOPE.
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(const char* name)
+			: m_Name(name), m_pBuffer(Profiler::GetThreadBuffer())
+		{
+			m_nDepth = m_pBuffer->Enter();
+			m_nBegin = Profiler::Now();
+		}
+
+		~ProfileScope()
+		{
+			m_pBuffer->Leave(m_Name, m_nBegin, Profiler::Now(), m_nDepth);
+		}
+
+	private:
+		const char* m_Name;
+		ProfileBuffer* m_pBuffer;
+		uint64_t m_nBegin;
+		uint32_t m_nDepth;
+
+		ProfileScope(const ProfileScope&);
+		ProfileScope& operator=(const ProfileScope&);
+	};
+}
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(MY_PROFILER_DISABLED)
+#define PROFILE_SCOPE(name)
+#else
+/// Times the enclosing block. 'name' must be a string with static storage.
+#define PROFILE_SCOPE(name) My::ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(name)
+#endif
@@ -0,0 +1,262 @@
+#pragma once
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "MemoryManager.hpp"
+#include "geommath.hpp"
+
+namespace My {
+	extern MemoryManager* g_pMemoryManager;
+
+	// Structure-of-arrays storage: one array per field instead of one array
+	// of structs, so the GeomMath *SoA kernels fill every SIMD lane with a
+	// useful component. Fields must be trivially copyable scalars.
+
+	namespace detail {
+		template<typename... Types>
+		struct AllTriviallyCopyable : std::true_type {};
+
+		template<typename T, typename... Rest>
+		struct AllTriviallyCopyable<T, Rest...>
+			: std::integral_constant<bool, std::is_trivially_copyable<T>::value && AllTriviallyCopyable<Rest...>::value> {};
+	}
+
+	/// Component pointers of a range of SoA elements; pass Get<I>() for each
+	/// component array and Count() as the count of a GeomMath SoA kernel.
+	template<typename... Fields>
+	struct SoAView
+	{
+		std::tuple<Fields*...> arrays;
+		size_t                 count;
+
+		template<size_t I>
+		typename std::tuple_element<I, std::tuple<Fields...>>::type* Get() const { return std::get<I>(arrays); }
+
+		int32_t Count() const { return static_cast<int32_t>(count); }
+
+		/// Elements [first, first + n), e.g. one job's share of a parallel pass.
+		SoAView Slice(size_t first, size_t n) const {
+			return Offset(first, n, std::index_sequence_for<Fields...>());
+		}
+
+	private:
+		template<size_t... I>
+		SoAView Offset(size_t first, size_t n, std::index_sequence<I...>) const {
+			return SoAView{ std::make_tuple((std::get<I>(arrays) + first)...), n };
+		}
+	};
+
+	/// Growable SoA container allocated through the MemoryManager. Every
+	/// field array starts on a cache line, and the capacity is a multiple of
+	/// kPadding elements, the widest ISPC gang, so kernels may run whole
+	/// gangs past Size(). Elements in [Size(), Capacity()) are kept zero.
+	template<typename... Fields>
+	class SoAArray
+	{
+	public:
+		static const size_t kFieldCount = sizeof...(Fields);
+		static const size_t kAlignment = 64;
+		static const size_t kPadding = 16;
+
+		template<size_t I>
+		using FieldType = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+		SoAArray() : m_pData(nullptr), m_nSize(0), m_nCapacity(0), m_nBytes(0) {
+			for (size_t i = 0; i < kFieldCount; i++)
+				m_offsets[i] = 0;
+		}
+		explicit SoAArray(size_t size) : SoAArray() { Resize(size); }
+
+		SoAArray(SoAArray&& other) : SoAArray() { Swap(other); }
+
+		SoAArray& operator=(SoAArray&& other) {
+			if (this != &other) {
+				Release();
+				Swap(other);
+			}
+			return *this;
+		}
+
+		~SoAArray() { Release(); }
+
+		size_t Size() const { return m_nSize; }
+		size_t Capacity() const { return m_nCapacity; }
+		bool Empty() const { return m_nSize == 0; }
+
+		void Reserve(size_t capacity) {
+			if (capacity > m_nCapacity)
+				Reallocate(capacity);
+		}
+
+		/// New elements are zero.
+		void Resize(size_t size) {
+			Reserve(size);
+			if (size < m_nSize)
+				ZeroTail(size);
+			m_nSize = size;
+		}
+
+		void Clear() { Resize(0); }
+
+		void PushBack(Fields... values) {
+			if (m_nSize == m_nCapacity)
+				Reallocate(m_nCapacity ? m_nCapacity * 2 : kPadding);
+			m_nSize++;
+			Set(m_nSize - 1, values...);
+		}
+
+		void Set(size_t i, Fields... values) {
+			SetFields(i, std::index_sequence_for<Fields...>(), values...);
+		}
+
+		std::tuple<Fields...> Get(size_t i) const {
+			return GetFields(i, std::index_sequence_for<Fields...>());
+		}
+
+		template<size_t I>
+		FieldType<I>* Data() { return reinterpret_cast<FieldType<I>*>(m_pData + m_offsets[I]); }
+
+		template<size_t I>
+		const FieldType<I>* Data() const { return reinterpret_cast<const FieldType<I>*>(m_pData + m_offsets[I]); }
+
+		SoAView<Fields...> View() {
+			return MakeView<SoAView<Fields...>>(std::index_sequence_for<Fields...>());
+		}
+
+		SoAView<const Fields...> View() const {
+			return MakeView<SoAView<const Fields...>>(std::index_sequence_for<Fields...>());
+		}
+
+	private:
+		static_assert(sizeof...(Fields) > 0, "SoAArray needs at least one field");
+		static_assert(detail::AllTriviallyCopyable<Fields...>::value, "SoAArray fields are moved with memcpy");
+
+		static size_t AlignUp(size_t value, size_t alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		void Reallocate(size_t capacity) {
+			capacity = AlignUp(capacity, kPadding);
+
+			const size_t sizes[] = { sizeof(Fields)... };
+			size_t offsets[kFieldCount];
+			size_t bytes = 0;
+			for (size_t i = 0; i < kFieldCount; i++) {
+				offsets[i] = bytes;
+				bytes += AlignUp(capacity * sizes[i], kAlignment);
+			}
+
+			uint8_t* pData = reinterpret_cast<uint8_t*>(g_pMemoryManager->AllocateAligned(bytes, kAlignment));
+			memset(pData, 0, bytes);
+			if (m_pData) {
+				for (size_t i = 0; i < kFieldCount; i++)
+					memcpy(pData + offsets[i], m_pData + m_offsets[i], m_nSize * sizes[i]);
+			}
+
+			Release();
+			m_pData = pData;
+			m_nCapacity = capacity;
+			m_nBytes = bytes;
+			for (size_t i = 0; i < kFieldCount; i++)
+				m_offsets[i] = offsets[i];
+		}
+
+		void Release() {
+			if (m_pData)
+				g_pMemoryManager->FreeAligned(m_pData, m_nBytes, kAlignment);
+			m_pData = nullptr;
+			m_nCapacity = 0;
+			m_nBytes = 0;
+		}
+
+		void Swap(SoAArray& other) {
+			std::swap(m_pData, other.m_pData);
+			std::swap(m_nSize, other.m_nSize);
+			std::swap(m_nCapacity, other.m_nCapacity);
+			std::swap(m_nBytes, other.m_nBytes);
+			for (size_t i = 0; i < kFieldCount; i++)
+				std::swap(m_offsets[i], other.m_offsets[i]);
+		}
+
+		void ZeroTail(size_t first) {
+			const size_t sizes[] = { sizeof(Fields)... };
+			for (size_t i = 0; i < kFieldCount; i++)
+				memset(m_pData + m_offsets[i] + first * sizes[i], 0, (m_nSize - first) * sizes[i]);
+		}
+
+		template<size_t... I>
+		void SetFields(size_t i, std::index_sequence<I...>, Fields... values) {
+			int expand[] = { (Data<I>()[i] = values, 0)... };
+			(void)expand;
+		}
+
+		template<size_t... I>
+		std::tuple<Fields...> GetFields(size_t i, std::index_sequence<I...>) const {
+			return std::tuple<Fields...>(Data<I>()[i]...);
+		}
+
+		template<typename ViewType, size_t... I>
+		ViewType MakeView(std::index_sequence<I...>) const {
+			return ViewType{ std::make_tuple(const_cast<FieldType<I>*>(Data<I>())...), m_nSize };
+		}
+
+		uint8_t* m_pData;
+		size_t   m_nSize;
+		size_t   m_nCapacity;
+		size_t   m_nBytes;
+		size_t   m_offsets[kFieldCount];
+
+		SoAArray(const SoAArray& clone);
+		SoAArray& operator=(const SoAArray& rhs);
+	};
+
+	/// float3 data (positions, normals, velocities) as x, y and z arrays,
+	/// the layout taken by TransformPointsSoA and the other *SoA kernels.
+	class Vector3SoA : public SoAArray<float, float, float>
+	{
+	public:
+		using SoAArray::SoAArray;
+		using SoAArray::PushBack;
+		using SoAArray::Set;
+
+		float* X() { return Data<0>(); }
+		float* Y() { return Data<1>(); }
+		float* Z() { return Data<2>(); }
+		const float* X() const { return Data<0>(); }
+		const float* Y() const { return Data<1>(); }
+		const float* Z() const { return Data<2>(); }
+
+		void PushBack(const Vector3f& v) { PushBack(v.x, v.y, v.z); }
+		void Set(size_t i, const Vector3f& v) { Set(i, v.x, v.y, v.z); }
+		Vector3f operator[](size_t i) const { return Vector3f(X()[i], Y()[i], Z()[i]); }
+
+		/// Replaces the contents with 'count' float3 read every 'strideBytes'
+		/// from an interleaved buffer, e.g. the positions of a SimpleMesh.
+		void AssignInterleaved(const void* pBuffer, size_t strideBytes, size_t count) {
+			Clear();
+			Resize(count);
+			const uint8_t* p = reinterpret_cast<const uint8_t*>(pBuffer);
+			float* x = X();
+			float* y = Y();
+			float* z = Z();
+			for (size_t i = 0; i < count; i++, p += strideBytes) {
+				const float* v = reinterpret_cast<const float*>(p);
+				x[i] = v[0]; y[i] = v[1]; z[i] = v[2];
+			}
+		}
+
+		/// Writes the elements back as float3 every 'strideBytes', leaving
+		/// the rest of each interleaved vertex untouched.
+		void CopyToInterleaved(void* pBuffer, size_t strideBytes) const {
+			uint8_t* p = reinterpret_cast<uint8_t*>(pBuffer);
+			const float* x = X();
+			const float* y = Y();
+			const float* z = Z();
+			for (size_t i = 0; i < Size(); i++, p += strideBytes) {
+				float* v = reinterpret_cast<float*>(p);
+				v[0] = x[i]; v[1] = y[i]; v[2] = z[i];
+			}
+		}
+	};
+}
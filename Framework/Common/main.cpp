@@ -1,7 +1,13 @@
 #include "stdio.h"
+#include <stdlib.h>
+#include <string.h>
 #include "IApplication.hpp"
 #include "GraphicsManager.hpp"
 #include "MemoryManager.hpp"
+#include "Profiler.hpp"
+#include "FrameStatistics.hpp"
+#include "Logger.hpp"
+#include "EventBus.hpp"
 
 using namespace My;
 
@@ -9,37 +15,110 @@ namespace My {
 	extern IApplication* g_pApp;
 	extern MemoryManager* g_pMemoryManager;
 	extern GraphicsManager* g_pGraphicsManager;
+	extern Profiler* g_pProfiler;
+	extern Logger* g_pLogger;
+	extern EventBus* g_pEventBus;
 }
 
 int main(int argc, char** argv)
 {
 	int ret;
+	uint64_t nBenchmarkFrames = 0;
+	const char* pBenchmarkOutput = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--profile-trace") == 0 && i + 1 < argc) {
+			g_pProfiler->SetTraceOutput(argv[++i]);
+		} else if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc) {
+			nBenchmarkFrames = strtoull(argv[++i], nullptr, 10);
+		} else if (strcmp(argv[i], "--benchmark-output") == 0 && i + 1 < argc) {
+			pBenchmarkOutput = argv[++i];
+		}
+	}
+
+	g_pApp->SetCommandLineParameters(argc, argv);
+
+	FrameStatistics stats;
+	stats.Reset(static_cast<size_t>(nBenchmarkFrames));
+
+	// benchmark runs keep stdout for the report
+	ConsoleLogSink stderrSink(kLogLevelDebug);
+	if (nBenchmarkFrames) {
+		g_pLogger->AddSink(&stderrSink);
+	}
+
+	if ((ret = g_pLogger->Initialize()) != 0) {
+		printf("Logger Initialize failed, will exit now.");
+		return ret;
+	}
+
+	if ((ret = g_pProfiler->Initialize()) != 0) {
+		LOG_ERROR("Profiler Initialize failed, will exit now.");
+		g_pLogger->Finalize();
+		return ret;
+	}
 
 	if ((ret = g_pApp->Initialize()) != 0) {
-		printf("App Initialize Failed");
+		LOG_ERROR("App Initialize Failed");
+		g_pLogger->Finalize();
 		return ret;
 	}
 
 	if ((ret = g_pMemoryManager->Initialize()) != 0) {
-		printf("Memory Manager Initialize failed, will exit now.");
+		LOG_ERROR("Memory Manager Initialize failed, will exit now.");
+		g_pLogger->Finalize();
+		return ret;
+	}
+
+	if ((ret = g_pEventBus->Initialize()) != 0) {
+		LOG_ERROR("Event Bus Initialize failed, will exit now.");
+		g_pLogger->Finalize();
 		return ret;
 	}
 
 	if ((ret = g_pGraphicsManager->Initialize()) != 0) {
-		printf("Graphics Manager Initialize failed, will exit now.");
+		LOG_ERROR("Graphics Manager Initialize failed, will exit now.");
+		g_pLogger->Finalize();
 		return ret;
 	}
 
 	while (!g_pApp->IsQuit()) {
-		g_pApp->Tick();
-		g_pMemoryManager->Tick();
-		g_pGraphicsManager->Tick();
+		{
+			PROFILE_SCOPE("Frame");
+			g_pEventBus->Tick();
+			g_pApp->Tick();
+			g_pMemoryManager->Tick();
+			g_pGraphicsManager->Tick();
+		}
+		g_pProfiler->Tick();
+
+		if (nBenchmarkFrames) {
+			stats.AddFrame(*g_pProfiler->GetLastFrame());
+			if (stats.GetFrameCount() >= nBenchmarkFrames) break;
+		}
 	}
 
 	g_pGraphicsManager->Finalize();
+	g_pEventBus->Finalize();
 	g_pMemoryManager->Finalize();
 
 	g_pApp->Finalize();
 
-	return 0;
+	g_pProfiler->Finalize();
+
+	// the flush thread is done with the console once Finalize() returns
+	g_pLogger->Finalize();
+
+	if (nBenchmarkFrames) {
+		FILE* fp = pBenchmarkOutput ? fopen(pBenchmarkOutput, "w") : stdout;
+		if (fp) {
+			stats.WriteJson(fp);
+			if (fp != stdout) fclose(fp);
+		} else {
+			fprintf(stderr, "Cannot open benchmark output %s\n", pBenchmarkOutput);
+			ret = -1;
+		}
+	}
+
+	return ret;
 }
\ No newline at end of file
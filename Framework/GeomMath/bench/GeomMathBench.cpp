@@ -0,0 +1,502 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "geommath.hpp"
+#include "CrossProduct.h"
+#include "DotProduct.h"
+#include "MatrixMultiply.h"
+#include "Rotation.h"
+#include "Transform.h"
+#include "Transpose.h"
+
+// Microbenchmarks for the GeomMath primitives. Every primitive is timed in
+// up to three implementations over the same data:
+//   kernel   - the GeomMath library (ISPC, or the portable C++ twins when
+//              the library was built without ISPC; see "backend")
+//   geommath - the inline functions of geommath.hpp, one element per call
+//   plain    - straightforward loops left to the compiler's vectorizer
+//
+// Results go out as JSON. Every implementation's output is compared element
+// by element with the output of "plain" (after bringing it to the same
+// layout); on a mismatch the run exits with 1, so a broken kernel fails the
+// benchmark job as well. The checksum reported with each result weighs
+// elements by position, so it also changes when values swap places.
+
+#ifndef GEOMMATH_KERNEL_BACKEND
+#define GEOMMATH_KERNEL_BACKEND "unknown"
+#endif
+
+using namespace My;
+
+namespace {
+	// enough room for one 4x4 matrix per element
+	const size_t kFloatsPerElement = 16;
+	const int kInputCount = 6;
+	const int kOutputCount = 3;
+
+	static_assert(sizeof(Vector3f) == 3 * sizeof(float), "Vector3f is expected to be packed");
+
+	/// Inputs are SoA streams; the 3-vectors (x, y, z) = in[0..2] and
+	/// in[3..5] are also kept packed, which is the Vector3f layout, so every
+	/// implementation sees the same values in its natural layout.
+	struct Workspace
+	{
+		std::vector<Vector4f> storage;
+		float*     in[kInputCount];
+		float*     out[kOutputCount];
+		float*     packed[2];
+		Matrix4X4f matrix;
+
+		void Resize(size_t elements)
+		{
+			size_t floats = elements * kFloatsPerElement;
+			storage.resize(((kInputCount + kOutputCount) * floats + 2 * 3 * elements + 3) / 4);
+			float* p = storage.front().data;
+			for (int i = 0; i < kInputCount; i++, p += floats) in[i] = p;
+			for (int i = 0; i < kOutputCount; i++, p += floats) out[i] = p;
+			for (int i = 0; i < 2; i++, p += elements * 3) packed[i] = p;
+
+			// angles and coordinates in [-4, 4), reproducible between runs
+			uint32_t seed = 12345u;
+			for (int i = 0; i < kInputCount; i++) {
+				for (size_t j = 0; j < floats; j++) {
+					seed = seed * 1664525u + 1013904223u;
+					in[i][j] = (seed >> 8) * (8.0f / 16777216.0f) - 4.0f;
+				}
+			}
+
+			for (int v = 0; v < 2; v++) {
+				for (size_t j = 0; j < elements; j++) {
+					for (int k = 0; k < 3; k++)
+						packed[v][j * 3 + k] = in[v * 3 + k][j];
+				}
+			}
+
+			Matrix4X4f rotation, translation;
+			MatrixRotationYawPitchRoll(rotation, 0.3f, -1.1f, 2.0f);
+			MatrixTranslation(translation, 1.0f, -2.0f, 3.0f);
+			MatrixMultiply(matrix, rotation, translation);
+		}
+	};
+
+	typedef void (*RunFunc)(Workspace& ws, size_t n);
+	/// Copies the output of a run to 'result' in element order, vectors and
+	/// matrices packed, whatever layout the implementation writes.
+	typedef void (*OutputFunc)(const Workspace& ws, size_t n, std::vector<float>& result);
+
+	struct Case
+	{
+		const char*  primitive;
+		const char*  implementation;
+		size_t       bytesPerElement; ///< read + written
+		RunFunc      run;
+		OutputFunc   output;
+		bool         unordered;       ///< only matches "plain" as a multiset
+	};
+
+	void Packed(const float* p, size_t count, std::vector<float>& result)
+	{
+		result.assign(p, p + count);
+	}
+
+	/// Interleaves the x, y and z streams of out[0..2].
+	void PackedSoA3(const Workspace& ws, size_t n, std::vector<float>& result)
+	{
+		result.resize(n * 3);
+		for (size_t i = 0; i < n; i++)
+			for (int k = 0; k < 3; k++)
+				result[i * 3 + k] = ws.out[k][i];
+	}
+
+	/// Sum of the elements weighted by ((i % 7) + 1), for the report.
+	double Checksum(const std::vector<float>& values)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < values.size(); i++)
+			sum += values[i] * static_cast<double>((i % 7) + 1);
+		return sum;
+	}
+
+	// widest power of two not above sqrt(n) that divides n
+	size_t TransposeColumns(size_t n)
+	{
+		size_t columns = 1;
+		while (columns * columns * 4 <= n && n % (columns * 2) == 0) columns *= 2;
+		return columns;
+	}
+
+	const Case kCases[] = {
+		// a x b for n pairs of 3-vectors
+		{ "cross", "kernel", 36,
+			[](Workspace& ws, size_t n) {
+				for (size_t i = 0; i < n; i++)
+					ispc::CrossProduct(ws.packed[0] + i * 3, ws.packed[1] + i * 3, ws.out[0] + i * 3);
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 3, r); } },
+		{ "cross", "geommath", 36,
+			[](Workspace& ws, size_t n) {
+				const Vector3f* a = reinterpret_cast<const Vector3f*>(ws.packed[0]);
+				const Vector3f* b = reinterpret_cast<const Vector3f*>(ws.packed[1]);
+				Vector3f* r = reinterpret_cast<Vector3f*>(ws.out[0]);
+				for (size_t i = 0; i < n; i++)
+					r[i] = CrossProduct(a[i], b[i]);
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 3, r); } },
+		{ "cross", "plain", 36,
+			[](Workspace& ws, size_t n) {
+				const float *ax = ws.in[0], *ay = ws.in[1], *az = ws.in[2];
+				const float *bx = ws.in[3], *by = ws.in[4], *bz = ws.in[5];
+				float *rx = ws.out[0], *ry = ws.out[1], *rz = ws.out[2];
+				for (size_t i = 0; i < n; i++) {
+					rx[i] = ay[i] * bz[i] - az[i] * by[i];
+					ry[i] = az[i] * bx[i] - ax[i] * bz[i];
+					rz[i] = ax[i] * by[i] - ay[i] * bx[i];
+				}
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { PackedSoA3(ws, n, r); } },
+
+		// sum of a[i] * b[i] over n floats
+		{ "dot", "kernel", 8,
+			[](Workspace& ws, size_t n) {
+				ispc::DotProduct(ws.in[0], ws.in[1], ws.out[0], static_cast<int32_t>(n));
+			},
+			[](const Workspace& ws, size_t, std::vector<float>& r) { Packed(ws.out[0], 1, r); } },
+		{ "dot", "geommath", 8,
+			[](Workspace& ws, size_t n) {
+				const Vector4f* a = reinterpret_cast<const Vector4f*>(ws.in[0]);
+				const Vector4f* b = reinterpret_cast<const Vector4f*>(ws.in[1]);
+				float sum = 0.0f;
+				for (size_t i = 0; i < n / 4; i++)
+					sum += DotProduct(a[i], b[i]);
+				ws.out[0][0] = sum;
+			},
+			[](const Workspace& ws, size_t, std::vector<float>& r) { Packed(ws.out[0], 1, r); } },
+		{ "dot", "plain", 8,
+			[](Workspace& ws, size_t n) {
+				const float *a = ws.in[0], *b = ws.in[1];
+				float sum = 0.0f;
+				for (size_t i = 0; i < n; i++)
+					sum += a[i] * b[i];
+				ws.out[0][0] = sum;
+			},
+			[](const Workspace& ws, size_t, std::vector<float>& r) { Packed(ws.out[0], 1, r); } },
+
+		// n points by one affine 4x4
+		{ "transform", "kernel", 24,
+			[](Workspace& ws, size_t n) {
+				ispc::TransformPointsSoA(ws.matrix.flat, ws.in[0], ws.in[1], ws.in[2],
+					ws.out[0], ws.out[1], ws.out[2], static_cast<int32_t>(n));
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { PackedSoA3(ws, n, r); } },
+		{ "transform", "geommath", 24,
+			[](Workspace& ws, size_t n) {
+				const Vector3f* p = reinterpret_cast<const Vector3f*>(ws.packed[0]);
+				Vector3f* r = reinterpret_cast<Vector3f*>(ws.out[0]);
+				for (size_t i = 0; i < n; i++)
+					r[i] = TransformPoint(p[i], ws.matrix);
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 3, r); } },
+		{ "transform", "plain", 24,
+			[](Workspace& ws, size_t n) {
+				const float* m = ws.matrix.flat;
+				const float *x = ws.in[0], *y = ws.in[1], *z = ws.in[2];
+				float *ox = ws.out[0], *oy = ws.out[1], *oz = ws.out[2];
+				for (size_t i = 0; i < n; i++) {
+					ox[i] = x[i] * m[0] + y[i] * m[4] + z[i] * m[8] + m[12];
+					oy[i] = x[i] * m[1] + y[i] * m[5] + z[i] * m[9] + m[13];
+					oz[i] = x[i] * m[2] + y[i] * m[6] + z[i] * m[10] + m[14];
+				}
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { PackedSoA3(ws, n, r); } },
+
+		// n independent 4x4 products
+		{ "multiply", "kernel", 192,
+			[](Workspace& ws, size_t n) {
+				ispc::MatrixMultiplyBatch(ws.in[0], ws.in[1], ws.out[0], static_cast<int32_t>(n));
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 16, r); } },
+		{ "multiply", "geommath", 192,
+			[](Workspace& ws, size_t n) {
+				const Matrix4X4f* a = reinterpret_cast<const Matrix4X4f*>(ws.in[0]);
+				const Matrix4X4f* b = reinterpret_cast<const Matrix4X4f*>(ws.in[1]);
+				Matrix4X4f* r = reinterpret_cast<Matrix4X4f*>(ws.out[0]);
+				for (size_t i = 0; i < n; i++)
+					MatrixMultiply(r[i], a[i], b[i]);
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 16, r); } },
+		{ "multiply", "plain", 192,
+			[](Workspace& ws, size_t n) {
+				for (size_t k = 0; k < n; k++) {
+					const float* a = ws.in[0] + k * 16;
+					const float* b = ws.in[1] + k * 16;
+					float* r = ws.out[0] + k * 16;
+					for (int i = 0; i < 4; i++)
+						for (int j = 0; j < 4; j++)
+							r[i * 4 + j] = a[i * 4] * b[j] + a[i * 4 + 1] * b[4 + j]
+								+ a[i * 4 + 2] * b[8 + j] + a[i * 4 + 3] * b[12 + j];
+				}
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 16, r); } },
+
+		// one matrix of n floats, as close to square as a power of two allows
+		{ "transpose", "kernel", 8,
+			[](Workspace& ws, size_t n) {
+				size_t columns = TransposeColumns(n);
+				ispc::Transpose(ws.in[0], ws.out[0], static_cast<int32_t>(n / columns), static_cast<int32_t>(columns));
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n, r); } },
+		{ "transpose", "geommath", 8,
+			[](Workspace& ws, size_t n) {
+				// geommath only transposes small matrices: n / 16 4x4 blocks
+				const Matrix4X4f* a = reinterpret_cast<const Matrix4X4f*>(ws.in[0]);
+				Matrix4X4f* r = reinterpret_cast<Matrix4X4f*>(ws.out[0]);
+				for (size_t i = 0; i < n / 16; i++)
+					Transpose(r[i], a[i]);
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n, r); }, true },
+		{ "transpose", "plain", 8,
+			[](Workspace& ws, size_t n) {
+				size_t columns = TransposeColumns(n);
+				size_t rows = n / columns;
+				for (size_t i = 0; i < rows; i++)
+					for (size_t j = 0; j < columns; j++)
+						ws.out[0][j * rows + i] = ws.in[0][i * columns + j];
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n, r); } },
+
+		// n 3x3 matrices from yaw/pitch/roll
+		{ "rotation_ypr", "kernel", 48,
+			[](Workspace& ws, size_t n) {
+				ispc::BuildYawPitchRollMatrices(ws.in[0], ws.in[1], ws.in[2], ws.out[0], static_cast<int32_t>(n), false);
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 9, r); } },
+		{ "rotation_ypr", "kernel_accurate", 48,
+			[](Workspace& ws, size_t n) {
+				ispc::BuildYawPitchRollMatrices(ws.in[0], ws.in[1], ws.in[2], ws.out[0], static_cast<int32_t>(n), true);
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 9, r); } },
+		{ "rotation_ypr", "geommath", 48,
+			[](Workspace& ws, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					Matrix3X3f m;
+					MatrixRotationYawPitchRoll(m, ws.in[0][i], ws.in[1][i], ws.in[2][i]);
+					memcpy(ws.out[0] + i * 9, m.flat, sizeof(m.flat));
+				}
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 9, r); } },
+		{ "rotation_ypr", "plain", 48,
+			[](Workspace& ws, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					float sYaw = sinf(ws.in[0][i]), cYaw = cosf(ws.in[0][i]);
+					float sPitch = sinf(ws.in[1][i]), cPitch = cosf(ws.in[1][i]);
+					float sRoll = sinf(ws.in[2][i]), cRoll = cosf(ws.in[2][i]);
+					float* m = ws.out[0] + i * 9;
+					m[0] = cRoll * cYaw + sRoll * sPitch * sYaw;
+					m[1] = sRoll * cPitch;
+					m[2] = cRoll * -sYaw + sRoll * sPitch * cYaw;
+					m[3] = -sRoll * cYaw + cRoll * sPitch * sYaw;
+					m[4] = cRoll * cPitch;
+					m[5] = sRoll * sYaw + cRoll * sPitch * cYaw;
+					m[6] = cPitch * sYaw;
+					m[7] = -sPitch;
+					m[8] = cPitch * cYaw;
+				}
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 9, r); } },
+
+		// n 4x4 rotations about y
+		{ "rotation_axis", "kernel", 68,
+			[](Workspace& ws, size_t n) {
+				ispc::BuildAxisRotationMatrices(ws.in[0], 1, ws.out[0], static_cast<int32_t>(n), false);
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 16, r); } },
+		{ "rotation_axis", "geommath", 68,
+			[](Workspace& ws, size_t n) {
+				Matrix4X4f* r = reinterpret_cast<Matrix4X4f*>(ws.out[0]);
+				for (size_t i = 0; i < n; i++)
+					MatrixRotationY(r[i], ws.in[0][i]);
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 16, r); } },
+		{ "rotation_axis", "plain", 68,
+			[](Workspace& ws, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					float c = cosf(ws.in[0][i]), s = sinf(ws.in[0][i]);
+					float* m = ws.out[0] + i * 16;
+					m[0] = c;    m[1] = 0.0f;  m[2] = -s;    m[3] = 0.0f;
+					m[4] = 0.0f; m[5] = 1.0f;  m[6] = 0.0f;  m[7] = 0.0f;
+					m[8] = s;    m[9] = 0.0f;  m[10] = c;    m[11] = 0.0f;
+					m[12] = 0.0f; m[13] = 0.0f; m[14] = 0.0f; m[15] = 1.0f;
+				}
+			},
+			[](const Workspace& ws, size_t n, std::vector<float>& r) { Packed(ws.out[0], n * 16, r); } },
+	};
+
+	const size_t kCaseCount = sizeof(kCases) / sizeof(kCases[0]);
+
+	// fast sincos is good to ~3e-4, everything else to float rounding
+	const double kTolerance = 1e-3;
+
+	/// Index of the first element of 'values' off 'reference' by more than
+	/// the tolerance, or reference.size() when they agree. Unordered outputs
+	/// are compared sorted.
+	size_t FirstMismatch(std::vector<float>& values, std::vector<float>& reference, bool unordered)
+	{
+		if (values.size() != reference.size())
+			return 0;
+		if (unordered) {
+			std::sort(values.begin(), values.end());
+			std::sort(reference.begin(), reference.end());
+		}
+		for (size_t i = 0; i < values.size(); i++) {
+			if (!(fabs(static_cast<double>(values[i]) - reference[i]) <= kTolerance * (fabs(reference[i]) + 1.0)))
+				return i;
+		}
+		return reference.size();
+	}
+
+	double Seconds(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+	{
+		return std::chrono::duration<double>(end - begin).count();
+	}
+
+	/// Best time of one call in nanoseconds. Calls are grouped into batches
+	/// of at least ~1 ms so the clock resolution does not matter.
+	double Measure(const Case& c, Workspace& ws, size_t n, double minTime)
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		c.run(ws, n);
+
+		size_t iterations = 1;
+		double best = 1e300;
+		double total = 0.0;
+		while (total < minTime) {
+			Clock::time_point begin = Clock::now();
+			for (size_t i = 0; i < iterations; i++)
+				c.run(ws, n);
+			double elapsed = Seconds(begin, Clock::now());
+
+			total += elapsed;
+			if (elapsed < 1e-3) {
+				iterations *= 2;
+				continue;
+			}
+			best = elapsed / iterations < best ? elapsed / iterations : best;
+		}
+		if (best == 1e300)
+			best = total / iterations;
+		return best * 1e9;
+	}
+
+	void Usage(const char* name)
+	{
+		fprintf(stderr, "usage: %s [--sizes n,n,...] [--min-time seconds] [--filter primitive] [--output file]\n"
+			"sizes are element counts, rounded up to a multiple of 16\n", name);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<size_t> sizes = { 64, 1024, 16384, 262144 };
+	double minTime = 0.1;
+	const char* pFilter = nullptr;
+	const char* pOutput = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+			sizes.clear();
+			for (char* p = argv[++i]; *p; ) {
+				// whole 4x4 blocks keep every implementation on the same data
+				size_t n = (strtoull(p, &p, 10) + 15) & ~static_cast<size_t>(15);
+				if (n) sizes.push_back(n);
+				if (*p == ',') p++;
+				else if (*p) break;
+			}
+		} else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+			minTime = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			pFilter = argv[++i];
+		} else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+			pOutput = argv[++i];
+		} else if (strcmp(argv[i], "--help") == 0) {
+			Usage(argv[0]);
+			return 0;
+		} else {
+			Usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (sizes.empty()) {
+		Usage(argv[0]);
+		return 2;
+	}
+
+	FILE* fp = pOutput ? fopen(pOutput, "w") : stdout;
+	if (!fp) {
+		fprintf(stderr, "Cannot open benchmark output %s\n", pOutput);
+		return 2;
+	}
+
+	size_t largest = 0;
+	for (size_t n : sizes) largest = n > largest ? n : largest;
+
+	Workspace ws;
+	ws.Resize(largest);
+
+	std::vector<float> values, reference;
+	int ret = 0;
+	bool first = true;
+	fprintf(fp, "{\n  \"backend\": \"%s\",\n  \"results\": [", GEOMMATH_KERNEL_BACKEND);
+
+	for (size_t n : sizes) {
+		for (size_t i = 0; i < kCaseCount; i++) {
+			const Case& c = kCases[i];
+			if (pFilter && strcmp(pFilter, c.primitive) != 0)
+				continue;
+
+			double ns = Measure(c, ws, n, minTime);
+			c.output(ws, n, values);
+			double checksum = Checksum(values);
+
+			// "plain" comes last for every primitive
+			reference = values;
+			for (size_t j = i; j < kCaseCount && strcmp(kCases[j].primitive, c.primitive) == 0; j++) {
+				if (strcmp(kCases[j].implementation, "plain") == 0) {
+					kCases[j].run(ws, n);
+					kCases[j].output(ws, n, reference);
+					break;
+				}
+			}
+
+			size_t mismatch = FirstMismatch(values, reference, c.unordered);
+			bool match = mismatch == reference.size();
+			if (!match) {
+				fprintf(stderr, "%s/%s at %zu elements: output[%zu] is %g, expected %g\n",
+					c.primitive, c.implementation, n, mismatch,
+					mismatch < values.size() ? values[mismatch] : 0.0f,
+					mismatch < reference.size() ? reference[mismatch] : 0.0f);
+				ret = 1;
+			}
+
+			fprintf(fp, "%s\n    {\"primitive\": \"%s\", \"implementation\": \"%s\", \"elements\": %zu, "
+				"\"ns_per_element\": %.4f, \"gb_per_s\": %.3f, \"checksum\": %.6g, \"match\": %s}",
+				first ? "" : ",",
+				c.primitive, c.implementation, n,
+				ns / n,
+				static_cast<double>(c.bytesPerElement) * n / ns,
+				checksum,
+				match ? "true" : "false");
+			first = false;
+		}
+	}
+
+	fprintf(fp, "%s]\n}\n", first ? "" : "\n  ");
+	if (fp != stdout) fclose(fp);
+
+	return ret;
+}
@@ -0,0 +1,37 @@
+#include <limits>
+#include "Bounds.h"
+
+// Portable build of ispc/Bounds.ispc, used when ISPC is not available.
+
+void ispc::ComputeVertexBounds(const float* vertices, int32_t vertexStride, int32_t count,
+	float* bounds, double* sum)
+{
+	float minX = std::numeric_limits<float>::infinity(), minY = minX, minZ = minX;
+	float maxX = -minX, maxY = -minX, maxZ = -minX;
+	double sumX = 0.0, sumY = 0.0, sumZ = 0.0;
+
+	for (int32_t i = 0; i < count; i++) {
+		const float* p = vertices + i * vertexStride;
+		minX = p[0] < minX ? p[0] : minX; maxX = p[0] > maxX ? p[0] : maxX;
+		minY = p[1] < minY ? p[1] : minY; maxY = p[1] > maxY ? p[1] : maxY;
+		minZ = p[2] < minZ ? p[2] : minZ; maxZ = p[2] > maxZ ? p[2] : maxZ;
+		sumX += p[0]; sumY += p[1]; sumZ += p[2];
+	}
+
+	bounds[0] = minX; bounds[1] = minY; bounds[2] = minZ;
+	bounds[3] = maxX; bounds[4] = maxY; bounds[5] = maxZ;
+	sum[0] = sumX; sum[1] = sumY; sum[2] = sumZ;
+}
+
+void ispc::MaxDistanceSquared(const float* vertices, int32_t vertexStride, int32_t count,
+	const float* center, float* result)
+{
+	float m = 0.0f;
+	for (int32_t i = 0; i < count; i++) {
+		const float* p = vertices + i * vertexStride;
+		float dx = p[0] - center[0], dy = p[1] - center[1], dz = p[2] - center[2];
+		float d = dx * dx + dy * dy + dz * dz;
+		m = d > m ? d : m;
+	}
+	*result = m;
+}
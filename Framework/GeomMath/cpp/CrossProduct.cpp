@@ -0,0 +1,10 @@
+#include "CrossProduct.h"
+
+// Portable build of ispc/CrossProduct.ispc, used when ISPC is not available.
+
+void ispc::CrossProduct(const float* a, const float* b, float* result)
+{
+	result[0] = a[1] * b[2] - a[2] * b[1];
+	result[1] = a[2] * b[0] - a[0] * b[2];
+	result[2] = a[0] * b[1] - a[1] * b[0];
+}
@@ -0,0 +1,70 @@
+#include <math.h>
+#include "Culling.h"
+
+// Portable build of ispc/Culling.ispc, used when ISPC is not available.
+// The visibility test is evaluated without early exit and the index is
+// stored unconditionally, so the loops stay branch-free.
+
+int32_t ispc::CullSpheresSoA(const float* planes,
+	const float* cx, const float* cy, const float* cz, const float* radius,
+	int32_t indexBase, int32_t* visible, int32_t count)
+{
+	int32_t written = 0;
+	for (int32_t i = 0; i < count; i++) {
+		float x = cx[i], y = cy[i], z = cz[i], r = radius[i];
+		bool inside = true;
+		for (int p = 0; p < 6; p++) {
+			float distance = planes[p * 4] * x + planes[p * 4 + 1] * y + planes[p * 4 + 2] * z + planes[p * 4 + 3];
+			inside &= (distance >= -r);
+		}
+		visible[written] = indexBase + i;
+		written += inside ? 1 : 0;
+	}
+	return written;
+}
+
+int32_t ispc::CullSpheresAoS(const float* planes, const float* spheres,
+	int32_t indexBase, int32_t* visible, int32_t count)
+{
+	int32_t written = 0;
+	for (int32_t i = 0; i < count; i++) {
+		const float* s = spheres + i * 4;
+		bool inside = true;
+		for (int p = 0; p < 6; p++) {
+			float distance = planes[p * 4] * s[0] + planes[p * 4 + 1] * s[1] + planes[p * 4 + 2] * s[2] + planes[p * 4 + 3];
+			inside &= (distance >= -s[3]);
+		}
+		visible[written] = indexBase + i;
+		written += inside ? 1 : 0;
+	}
+	return written;
+}
+
+int32_t ispc::CullAABBsSoA(const float* planes,
+	const float* minX, const float* minY, const float* minZ,
+	const float* maxX, const float* maxY, const float* maxZ,
+	int32_t indexBase, int32_t* visible, int32_t count)
+{
+	float absPlanes[18];
+	for (int p = 0; p < 6; p++) {
+		absPlanes[p * 3]     = fabsf(planes[p * 4]);
+		absPlanes[p * 3 + 1] = fabsf(planes[p * 4 + 1]);
+		absPlanes[p * 3 + 2] = fabsf(planes[p * 4 + 2]);
+	}
+
+	int32_t written = 0;
+	for (int32_t i = 0; i < count; i++) {
+		float cx = (minX[i] + maxX[i]) * 0.5f, ex = (maxX[i] - minX[i]) * 0.5f;
+		float cy = (minY[i] + maxY[i]) * 0.5f, ey = (maxY[i] - minY[i]) * 0.5f;
+		float cz = (minZ[i] + maxZ[i]) * 0.5f, ez = (maxZ[i] - minZ[i]) * 0.5f;
+		bool inside = true;
+		for (int p = 0; p < 6; p++) {
+			float distance = planes[p * 4] * cx + planes[p * 4 + 1] * cy + planes[p * 4 + 2] * cz + planes[p * 4 + 3];
+			float r = absPlanes[p * 3] * ex + absPlanes[p * 3 + 1] * ey + absPlanes[p * 3 + 2] * ez;
+			inside &= (distance >= -r);
+		}
+		visible[written] = indexBase + i;
+		written += inside ? 1 : 0;
+	}
+	return written;
+}
@@ -0,0 +1,21 @@
+#include "DotProduct.h"
+
+// Portable build of ispc/DotProduct.ispc, used when ISPC is not available.
+// Separate partial sums let the compiler keep them in one vector register
+// without reassociating a single float sum.
+
+void ispc::DotProduct(const float* a, const float* b, float* result, int32_t count)
+{
+	float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	int32_t body = count & ~3;
+	for (int32_t i = 0; i < body; i += 4) {
+		sum[0] += a[i] * b[i];
+		sum[1] += a[i + 1] * b[i + 1];
+		sum[2] += a[i + 2] * b[i + 2];
+		sum[3] += a[i + 3] * b[i + 3];
+	}
+	for (int32_t i = body; i < count; i++) {
+		sum[0] += a[i] * b[i];
+	}
+	*result = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
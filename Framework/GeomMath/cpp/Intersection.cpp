@@ -0,0 +1,148 @@
+#include <math.h>
+#include "Intersection.h"
+
+// Portable build of ispc/Intersection.ispc, used when ISPC is not available.
+
+namespace {
+	inline float IntersectTriangle(const float* o, const float* d,
+		const float* a, const float* b, const float* c, float tMax, float& u, float& v)
+	{
+		float e1x = b[0] - a[0], e1y = b[1] - a[1], e1z = b[2] - a[2];
+		float e2x = c[0] - a[0], e2y = c[1] - a[1], e2z = c[2] - a[2];
+
+		float px = d[1] * e2z - d[2] * e2y;
+		float py = d[2] * e2x - d[0] * e2z;
+		float pz = d[0] * e2y - d[1] * e2x;
+		float det = e1x * px + e1y * py + e1z * pz;
+		if (fabsf(det) <= 1e-12f) return tMax;
+		float inv = 1.0f / det;
+
+		float sx = o[0] - a[0], sy = o[1] - a[1], sz = o[2] - a[2];
+		u = (sx * px + sy * py + sz * pz) * inv;
+		if (u < 0.0f || u > 1.0f) return tMax;
+
+		float qx = sy * e1z - sz * e1y;
+		float qy = sz * e1x - sx * e1z;
+		float qz = sx * e1y - sy * e1x;
+		v = (d[0] * qx + d[1] * qy + d[2] * qz) * inv;
+		if (v < 0.0f || u + v > 1.0f) return tMax;
+
+		float t = (e2x * qx + e2y * qy + e2z * qz) * inv;
+		return (t >= 0.0f && t < tMax) ? t : tMax;
+	}
+
+	template<typename Index>
+	int32_t IntersectRayTriangles(const float* origin, const float* direction, float tMax,
+		const float* vertices, int32_t vertexStride, const Index* indices, int32_t triangleCount,
+		float* hitT, float* hitU, float* hitV)
+	{
+		float bestT = tMax, bestU = 0.0f, bestV = 0.0f;
+		int32_t bestTriangle = -1;
+		for (int32_t tri = 0; tri < triangleCount; tri++) {
+			float u, v;
+			float t = IntersectTriangle(origin, direction,
+				vertices + indices[tri * 3] * vertexStride,
+				vertices + indices[tri * 3 + 1] * vertexStride,
+				vertices + indices[tri * 3 + 2] * vertexStride, bestT, u, v);
+			if (t < bestT) {
+				bestT = t; bestU = u; bestV = v; bestTriangle = tri;
+			}
+		}
+		if (bestTriangle >= 0) {
+			*hitT = bestT;
+			*hitU = bestU;
+			*hitV = bestV;
+		}
+		return bestTriangle;
+	}
+
+	template<typename Index>
+	void IntersectRaysTriangles(const float* vertices, int32_t vertexStride, const Index* indices, int32_t triangleCount,
+		const float* ox, const float* oy, const float* oz, const float* dx, const float* dy, const float* dz,
+		float* tHit, int32_t* hitTriangle, float* hitU, float* hitV, int32_t rayCount)
+	{
+		for (int32_t ray = 0; ray < rayCount; ray++) {
+			const float origin[3] = { ox[ray], oy[ray], oz[ray] };
+			const float direction[3] = { dx[ray], dy[ray], dz[ray] };
+			float t, u, v;
+			int32_t tri = IntersectRayTriangles(origin, direction, tHit[ray],
+				vertices, vertexStride, indices, triangleCount, &t, &u, &v);
+			if (tri >= 0) {
+				tHit[ray] = t;
+				hitTriangle[ray] = tri;
+				hitU[ray] = u;
+				hitV[ray] = v;
+			}
+		}
+	}
+
+	inline float IntersectBox(const float* o, float ix, float iy, float iz,
+		float minX, float minY, float minZ, float maxX, float maxY, float maxZ, float tMax)
+	{
+		float t1 = (minX - o[0]) * ix, t2 = (maxX - o[0]) * ix;
+		float tNear = fminf(t1, t2), tFar = fmaxf(t1, t2);
+		t1 = (minY - o[1]) * iy; t2 = (maxY - o[1]) * iy;
+		tNear = fmaxf(tNear, fminf(t1, t2)); tFar = fminf(tFar, fmaxf(t1, t2));
+		t1 = (minZ - o[2]) * iz; t2 = (maxZ - o[2]) * iz;
+		tNear = fmaxf(tNear, fminf(t1, t2)); tFar = fminf(tFar, fmaxf(t1, t2));
+
+		tNear = fmaxf(tNear, 0.0f);
+		return (tNear <= tFar && tNear < tMax) ? tNear : tMax;
+	}
+}
+
+int32_t ispc::IntersectRayTriangles16(const float* origin, const float* direction, float tMax,
+	const float* vertices, int32_t vertexStride, const uint16_t* indices, int32_t triangleCount,
+	float* hitT, float* hitU, float* hitV)
+{
+	return IntersectRayTriangles(origin, direction, tMax, vertices, vertexStride, indices, triangleCount, hitT, hitU, hitV);
+}
+
+int32_t ispc::IntersectRayTriangles32(const float* origin, const float* direction, float tMax,
+	const float* vertices, int32_t vertexStride, const uint32_t* indices, int32_t triangleCount,
+	float* hitT, float* hitU, float* hitV)
+{
+	return IntersectRayTriangles(origin, direction, tMax, vertices, vertexStride, indices, triangleCount, hitT, hitU, hitV);
+}
+
+void ispc::IntersectRaysTriangles16(const float* vertices, int32_t vertexStride, const uint16_t* indices, int32_t triangleCount,
+	const float* ox, const float* oy, const float* oz, const float* dx, const float* dy, const float* dz,
+	float* tHit, int32_t* hitTriangle, float* hitU, float* hitV, int32_t rayCount)
+{
+	IntersectRaysTriangles(vertices, vertexStride, indices, triangleCount, ox, oy, oz, dx, dy, dz, tHit, hitTriangle, hitU, hitV, rayCount);
+}
+
+void ispc::IntersectRaysTriangles32(const float* vertices, int32_t vertexStride, const uint32_t* indices, int32_t triangleCount,
+	const float* ox, const float* oy, const float* oz, const float* dx, const float* dy, const float* dz,
+	float* tHit, int32_t* hitTriangle, float* hitU, float* hitV, int32_t rayCount)
+{
+	IntersectRaysTriangles(vertices, vertexStride, indices, triangleCount, ox, oy, oz, dx, dy, dz, tHit, hitTriangle, hitU, hitV, rayCount);
+}
+
+int32_t ispc::IntersectRayAABBs(const float* origin, const float* direction, float tMax,
+	const float* minX, const float* minY, const float* minZ,
+	const float* maxX, const float* maxY, const float* maxZ,
+	int32_t* hits, int32_t count)
+{
+	float ix = 1.0f / direction[0], iy = 1.0f / direction[1], iz = 1.0f / direction[2];
+
+	int32_t written = 0;
+	for (int32_t i = 0; i < count; i++) {
+		float t = IntersectBox(origin, ix, iy, iz, minX[i], minY[i], minZ[i], maxX[i], maxY[i], maxZ[i], tMax);
+		hits[written] = i;
+		written += (t < tMax) ? 1 : 0;
+	}
+	return written;
+}
+
+void ispc::IntersectRaysAABB(const float* box, float tMax,
+	const float* ox, const float* oy, const float* oz,
+	const float* dx, const float* dy, const float* dz,
+	float* tNear, int32_t rayCount)
+{
+	for (int32_t ray = 0; ray < rayCount; ray++) {
+		const float origin[3] = { ox[ray], oy[ray], oz[ray] };
+		tNear[ray] = IntersectBox(origin, 1.0f / dx[ray], 1.0f / dy[ray], 1.0f / dz[ray],
+			box[0], box[1], box[2], box[3], box[4], box[5], tMax);
+	}
+}
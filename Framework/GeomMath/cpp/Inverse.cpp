@@ -0,0 +1,163 @@
+#include "Inverse.h"
+
+// Portable build of ispc/Inverse.ispc, used when ISPC is not available.
+
+namespace {
+	void StoreIdentity(float* r)
+	{
+		for (int k = 0; k < 16; k++)
+			r[k] = (k % 5 == 0) ? 1.0f : 0.0f;
+	}
+
+	// 3x3 part of the 4x4 at a, inverted through cofactors
+	bool Inverse3x3(const float* a, float r[9])
+	{
+		float a00 = a[0], a01 = a[1], a02 = a[2];
+		float a10 = a[4], a11 = a[5], a12 = a[6];
+		float a20 = a[8], a21 = a[9], a22 = a[10];
+
+		float c00 = a11 * a22 - a12 * a21;
+		float c01 = a12 * a20 - a10 * a22;
+		float c02 = a10 * a21 - a11 * a20;
+		float det = a00 * c00 + a01 * c01 + a02 * c02;
+		if (det == 0.0f)
+			return false;
+
+		float inv = 1.0f / det;
+		r[0] = c00 * inv;
+		r[1] = (a02 * a21 - a01 * a22) * inv;
+		r[2] = (a01 * a12 - a02 * a11) * inv;
+		r[3] = c01 * inv;
+		r[4] = (a00 * a22 - a02 * a20) * inv;
+		r[5] = (a02 * a10 - a00 * a12) * inv;
+		r[6] = c02 * inv;
+		r[7] = (a01 * a20 - a00 * a21) * inv;
+		r[8] = (a00 * a11 - a01 * a10) * inv;
+		return true;
+	}
+
+	bool InverseAffine(const float* a, float* result)
+	{
+		float r[9];
+		if (!Inverse3x3(a, r))
+			return false;
+
+		float tx = a[12], ty = a[13], tz = a[14];
+		result[0]  = r[0]; result[1]  = r[1]; result[2]  = r[2]; result[3]  = 0;
+		result[4]  = r[3]; result[5]  = r[4]; result[6]  = r[5]; result[7]  = 0;
+		result[8]  = r[6]; result[9]  = r[7]; result[10] = r[8]; result[11] = 0;
+		result[12] = -(tx * r[0] + ty * r[3] + tz * r[6]);
+		result[13] = -(tx * r[1] + ty * r[4] + tz * r[7]);
+		result[14] = -(tx * r[2] + ty * r[5] + tz * r[8]);
+		result[15] = 1;
+		return true;
+	}
+
+	bool InverseGeneral(const float* a, float* result)
+	{
+		float s0 = a[0] * a[5] - a[4] * a[1];
+		float s1 = a[0] * a[6] - a[4] * a[2];
+		float s2 = a[0] * a[7] - a[4] * a[3];
+		float s3 = a[1] * a[6] - a[5] * a[2];
+		float s4 = a[1] * a[7] - a[5] * a[3];
+		float s5 = a[2] * a[7] - a[6] * a[3];
+		float c5 = a[10] * a[15] - a[14] * a[11];
+		float c4 = a[9] * a[15] - a[13] * a[11];
+		float c3 = a[9] * a[14] - a[13] * a[10];
+		float c2 = a[8] * a[15] - a[12] * a[11];
+		float c1 = a[8] * a[14] - a[12] * a[10];
+		float c0 = a[8] * a[13] - a[12] * a[9];
+
+		float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+		if (det == 0.0f)
+			return false;
+		float inv = 1.0f / det;
+
+		float r[16] = {
+			( a[5] * c5 - a[6] * c4 + a[7] * c3) * inv,
+			(-a[1] * c5 + a[2] * c4 - a[3] * c3) * inv,
+			( a[13] * s5 - a[14] * s4 + a[15] * s3) * inv,
+			(-a[9] * s5 + a[10] * s4 - a[11] * s3) * inv,
+			(-a[4] * c5 + a[6] * c2 - a[7] * c1) * inv,
+			( a[0] * c5 - a[2] * c2 + a[3] * c1) * inv,
+			(-a[12] * s5 + a[14] * s2 - a[15] * s1) * inv,
+			( a[8] * s5 - a[10] * s2 + a[11] * s1) * inv,
+			( a[4] * c4 - a[5] * c2 + a[7] * c0) * inv,
+			(-a[0] * c4 + a[1] * c2 - a[3] * c0) * inv,
+			( a[12] * s4 - a[13] * s2 + a[15] * s0) * inv,
+			(-a[8] * s4 + a[9] * s2 - a[11] * s0) * inv,
+			(-a[4] * c3 + a[5] * c1 - a[6] * c0) * inv,
+			( a[0] * c3 - a[1] * c1 + a[2] * c0) * inv,
+			(-a[12] * s3 + a[13] * s1 - a[14] * s0) * inv,
+			( a[8] * s3 - a[9] * s1 + a[10] * s0) * inv,
+		};
+		for (int k = 0; k < 16; k++)
+			result[k] = r[k];
+		return true;
+	}
+}
+
+int32_t ispc::InverseMatrices(const float* a, float* result, int32_t count)
+{
+	int32_t singular = 0;
+	for (int32_t i = 0; i < count; i++) {
+		const float* m = a + i * 16;
+		bool affine = m[3] == 0.0f && m[7] == 0.0f && m[11] == 0.0f && m[15] == 1.0f;
+		bool ok = affine ? InverseAffine(m, result + i * 16) : InverseGeneral(m, result + i * 16);
+		if (!ok) {
+			StoreIdentity(result + i * 16);
+			singular++;
+		}
+	}
+	return singular;
+}
+
+int32_t ispc::InverseAffineMatrices(const float* a, float* result, int32_t count)
+{
+	int32_t singular = 0;
+	for (int32_t i = 0; i < count; i++) {
+		if (!InverseAffine(a + i * 16, result + i * 16)) {
+			StoreIdentity(result + i * 16);
+			singular++;
+		}
+	}
+	return singular;
+}
+
+void ispc::InverseRigidMatrices(const float* a, float* result, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		const float* m = a + i * 16;
+		float r00 = m[0], r01 = m[1], r02 = m[2];
+		float r10 = m[4], r11 = m[5], r12 = m[6];
+		float r20 = m[8], r21 = m[9], r22 = m[10];
+		float tx = m[12], ty = m[13], tz = m[14];
+
+		float* o = result + i * 16;
+		o[0]  = r00; o[1]  = r10; o[2]  = r20; o[3]  = 0;
+		o[4]  = r01; o[5]  = r11; o[6]  = r21; o[7]  = 0;
+		o[8]  = r02; o[9]  = r12; o[10] = r22; o[11] = 0;
+		o[12] = -(tx * r00 + ty * r01 + tz * r02);
+		o[13] = -(tx * r10 + ty * r11 + tz * r12);
+		o[14] = -(tx * r20 + ty * r21 + tz * r22);
+		o[15] = 1;
+	}
+}
+
+int32_t ispc::InverseTransposeMatrices(const float* a, float* result, int32_t count)
+{
+	int32_t singular = 0;
+	for (int32_t i = 0; i < count; i++) {
+		float r[9];
+		if (!Inverse3x3(a + i * 16, r)) {
+			for (int k = 0; k < 9; k++)
+				r[k] = (k % 4 == 0) ? 1.0f : 0.0f;
+			singular++;
+		}
+		float* o = result + i * 9;
+		o[0] = r[0]; o[1] = r[3]; o[2] = r[6];
+		o[3] = r[1]; o[4] = r[4]; o[5] = r[7];
+		o[6] = r[2]; o[7] = r[5]; o[8] = r[8];
+	}
+	return singular;
+}
@@ -0,0 +1,69 @@
+#include "Layout.h"
+
+// Portable build of ispc/Layout.ispc, used when ISPC is not available.
+
+namespace {
+	const int32_t kBlock = 256;
+}
+
+void ispc::AoSToSoA3(float* aos, float* x, float* y, float* z, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		x[i] = aos[i * 3];
+		y[i] = aos[i * 3 + 1];
+		z[i] = aos[i * 3 + 2];
+	}
+}
+
+void ispc::SoAToAoS3(float* x, float* y, float* z, float* aos, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		aos[i * 3]     = x[i];
+		aos[i * 3 + 1] = y[i];
+		aos[i * 3 + 2] = z[i];
+	}
+}
+
+void ispc::AoSToSoA4(float* aos, float* x, float* y, float* z, float* w, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		x[i] = aos[i * 4];
+		y[i] = aos[i * 4 + 1];
+		z[i] = aos[i * 4 + 2];
+		w[i] = aos[i * 4 + 3];
+	}
+}
+
+void ispc::SoAToAoS4(float* x, float* y, float* z, float* w, float* aos, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		aos[i * 4]     = x[i];
+		aos[i * 4 + 1] = y[i];
+		aos[i * 4 + 2] = z[i];
+		aos[i * 4 + 3] = w[i];
+	}
+}
+
+void ispc::AoSToSoA8(float* aos, float* soa, int32_t soaStride, int32_t count)
+{
+	for (int32_t b0 = 0; b0 < count; b0 += kBlock) {
+		int32_t b1 = b0 + kBlock < count ? b0 + kBlock : count;
+		for (int32_t k = 0; k < 8; k++) {
+			for (int32_t i = b0; i < b1; i++) {
+				soa[k * soaStride + i] = aos[i * 8 + k];
+			}
+		}
+	}
+}
+
+void ispc::SoAToAoS8(float* soa, int32_t soaStride, float* aos, int32_t count)
+{
+	for (int32_t b0 = 0; b0 < count; b0 += kBlock) {
+		int32_t b1 = b0 + kBlock < count ? b0 + kBlock : count;
+		for (int32_t k = 0; k < 8; k++) {
+			for (int32_t i = b0; i < b1; i++) {
+				aos[i * 8 + k] = soa[k * soaStride + i];
+			}
+		}
+	}
+}
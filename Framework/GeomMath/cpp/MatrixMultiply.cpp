@@ -0,0 +1,50 @@
+#include "MatrixMultiply.h"
+
+// Portable build of ispc/MatrixMultiply.ispc, used when ISPC is not available.
+
+namespace {
+	// r = a * b; rows are computed one at a time, so r may alias a
+	inline void Multiply4x4(const float* a, const float* b, float* r)
+	{
+		for (int row = 0; row < 4; row++) {
+			float x = a[row * 4], y = a[row * 4 + 1], z = a[row * 4 + 2], w = a[row * 4 + 3];
+			for (int c = 0; c < 4; c++) {
+				r[row * 4 + c] = x * b[c] + y * b[4 + c] + z * b[8 + c] + w * b[12 + c];
+			}
+		}
+	}
+}
+
+void ispc::MatrixMultiplyBatch(const float* a, const float* b, float* result, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		Multiply4x4(a + i * 16, b + i * 16, result + i * 16);
+	}
+}
+
+void ispc::MatrixMultiplyByMatrix(const float* a, const float* m, float* result, int32_t count)
+{
+	float mm[16];
+	for (int k = 0; k < 16; k++) {
+		mm[k] = m[k];
+	}
+
+	for (int32_t i = 0; i < count; i++) {
+		Multiply4x4(a + i * 16, mm, result + i * 16);
+	}
+}
+
+void ispc::ConcatenateHierarchy(const float* local, const int32_t* parent, float* world, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		if (parent[i] < 0) {
+			if (world != local) {
+				for (int k = 0; k < 16; k++) {
+					world[i * 16 + k] = local[i * 16 + k];
+				}
+			}
+		} else {
+			Multiply4x4(local + i * 16, world + parent[i] * 16, world + i * 16);
+		}
+	}
+}
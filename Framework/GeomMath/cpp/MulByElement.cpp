@@ -0,0 +1,10 @@
+#include "MulByElement.h"
+
+// Portable build of ispc/MulByElement.ispc, used when ISPC is not available.
+
+void ispc::MulByElement(float* a, float* b, float* result, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		result[i] = a[i] * b[i];
+	}
+}
@@ -0,0 +1,190 @@
+#include <math.h>
+#include <string.h>
+#include "Packing.h"
+
+// Portable build of ispc/Packing.ispc, used when ISPC is not available.
+
+namespace {
+	// round to nearest even, overflow to infinity, NaN stays NaN
+	inline uint16_t FloatToHalfBits(float f)
+	{
+		uint32_t bits;
+		memcpy(&bits, &f, sizeof(bits));
+
+		uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+		uint32_t magnitude = bits & 0x7fffffff;
+
+		if (magnitude >= 0x7f800000)
+			return sign | (magnitude > 0x7f800000 ? 0x7e00 : 0x7c00);
+		if (magnitude >= 0x477ff000) // rounds to 65536 and above
+			return sign | 0x7c00;
+		if (magnitude < 0x38800000) {
+			// subnormal half: let the FPU do the rounding
+			float a;
+			memcpy(&a, &magnitude, sizeof(a));
+			return sign | static_cast<uint16_t>(nearbyintf(a * 16777216.0f));
+		}
+
+		uint32_t rounded = magnitude + 0xfff + ((magnitude >> 13) & 1);
+		return sign | static_cast<uint16_t>((rounded - 0x38000000) >> 13);
+	}
+
+	inline float HalfBitsToFloat(uint16_t h)
+	{
+		uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+		uint32_t exponent = (h >> 10) & 0x1f;
+		uint32_t mantissa = h & 0x3ff;
+
+		float f;
+		if (exponent == 0) {
+			f = mantissa * (1.0f / 16777216.0f);
+			return sign ? -f : f;
+		}
+
+		uint32_t bits = exponent == 0x1f
+			? sign | 0x7f800000 | (mantissa << 13)
+			: sign | ((exponent + 112) << 23) | (mantissa << 13);
+		memcpy(&f, &bits, sizeof(f));
+		return f;
+	}
+
+	inline float Clamp(float v, float low, float high)
+	{
+		return v < low ? low : (v > high ? high : v);
+	}
+
+	template<typename T>
+	void FloatToNorm(const float* in, int32_t inStride, T* out, int32_t outStride,
+		int32_t components, int32_t count, float low, float scale)
+	{
+		for (int32_t i = 0; i < count; i++)
+			for (int32_t c = 0; c < components; c++)
+				out[i * outStride + c] = static_cast<T>(nearbyintf(Clamp(in[i * inStride + c], low, 1.0f) * scale));
+	}
+
+	template<typename T>
+	void NormToFloat(const T* in, int32_t inStride, float* out, int32_t outStride,
+		int32_t components, int32_t count, float low, float scale)
+	{
+		for (int32_t i = 0; i < count; i++) {
+			for (int32_t c = 0; c < components; c++) {
+				float v = static_cast<float>(in[i * inStride + c]) * (1.0f / scale);
+				out[i * outStride + c] = v > low ? v : low;
+			}
+		}
+	}
+
+	inline float SignNotZero(float v)
+	{
+		return v >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	template<typename T>
+	void EncodeOctahedral(const float* in, int32_t inStride, T* out, int32_t outStride, int32_t count, float scale)
+	{
+		for (int32_t i = 0; i < count; i++) {
+			const float* n = in + i * inStride;
+			float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+			float inv = l1 > 0.0f ? 1.0f / l1 : 0.0f;
+			float u = n[0] * inv, v = n[1] * inv;
+			if (n[2] < 0.0f) {
+				float fu = (1.0f - fabsf(v)) * SignNotZero(u);
+				float fv = (1.0f - fabsf(u)) * SignNotZero(v);
+				u = fu; v = fv;
+			}
+			out[i * outStride]     = static_cast<T>(nearbyintf(Clamp(u, -1.0f, 1.0f) * scale));
+			out[i * outStride + 1] = static_cast<T>(nearbyintf(Clamp(v, -1.0f, 1.0f) * scale));
+		}
+	}
+
+	template<typename T>
+	void DecodeOctahedral(const T* in, int32_t inStride, float* out, int32_t outStride, int32_t count, float scale)
+	{
+		for (int32_t i = 0; i < count; i++) {
+			float x = fmaxf(static_cast<float>(in[i * inStride]) * (1.0f / scale), -1.0f);
+			float y = fmaxf(static_cast<float>(in[i * inStride + 1]) * (1.0f / scale), -1.0f);
+			float z = 1.0f - fabsf(x) - fabsf(y);
+			float t = fmaxf(-z, 0.0f);
+			x += x >= 0.0f ? -t : t;
+			y += y >= 0.0f ? -t : t;
+			float s = 1.0f / sqrtf(x * x + y * y + z * z);
+			out[i * outStride]     = x * s;
+			out[i * outStride + 1] = y * s;
+			out[i * outStride + 2] = z * s;
+		}
+	}
+}
+
+void ispc::FloatToHalf(const float* in, int32_t inStride, uint16_t* out, int32_t outStride, int32_t components, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++)
+		for (int32_t c = 0; c < components; c++)
+			out[i * outStride + c] = FloatToHalfBits(in[i * inStride + c]);
+}
+
+void ispc::HalfToFloat(const uint16_t* in, int32_t inStride, float* out, int32_t outStride, int32_t components, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++)
+		for (int32_t c = 0; c < components; c++)
+			out[i * outStride + c] = HalfBitsToFloat(in[i * inStride + c]);
+}
+
+void ispc::FloatToSnorm16(const float* in, int32_t inStride, int16_t* out, int32_t outStride, int32_t components, int32_t count)
+{
+	FloatToNorm(in, inStride, out, outStride, components, count, -1.0f, 32767.0f);
+}
+
+void ispc::Snorm16ToFloat(const int16_t* in, int32_t inStride, float* out, int32_t outStride, int32_t components, int32_t count)
+{
+	NormToFloat(in, inStride, out, outStride, components, count, -1.0f, 32767.0f);
+}
+
+void ispc::FloatToUnorm16(const float* in, int32_t inStride, uint16_t* out, int32_t outStride, int32_t components, int32_t count)
+{
+	FloatToNorm(in, inStride, out, outStride, components, count, 0.0f, 65535.0f);
+}
+
+void ispc::Unorm16ToFloat(const uint16_t* in, int32_t inStride, float* out, int32_t outStride, int32_t components, int32_t count)
+{
+	NormToFloat(in, inStride, out, outStride, components, count, 0.0f, 65535.0f);
+}
+
+void ispc::FloatToSnorm8(const float* in, int32_t inStride, int8_t* out, int32_t outStride, int32_t components, int32_t count)
+{
+	FloatToNorm(in, inStride, out, outStride, components, count, -1.0f, 127.0f);
+}
+
+void ispc::Snorm8ToFloat(const int8_t* in, int32_t inStride, float* out, int32_t outStride, int32_t components, int32_t count)
+{
+	NormToFloat(in, inStride, out, outStride, components, count, -1.0f, 127.0f);
+}
+
+void ispc::FloatToUnorm8(const float* in, int32_t inStride, uint8_t* out, int32_t outStride, int32_t components, int32_t count)
+{
+	FloatToNorm(in, inStride, out, outStride, components, count, 0.0f, 255.0f);
+}
+
+void ispc::Unorm8ToFloat(const uint8_t* in, int32_t inStride, float* out, int32_t outStride, int32_t components, int32_t count)
+{
+	NormToFloat(in, inStride, out, outStride, components, count, 0.0f, 255.0f);
+}
+
+void ispc::EncodeOctahedral16(const float* in, int32_t inStride, int16_t* out, int32_t outStride, int32_t count)
+{
+	EncodeOctahedral(in, inStride, out, outStride, count, 32767.0f);
+}
+
+void ispc::DecodeOctahedral16(const int16_t* in, int32_t inStride, float* out, int32_t outStride, int32_t count)
+{
+	DecodeOctahedral(in, inStride, out, outStride, count, 32767.0f);
+}
+
+void ispc::EncodeOctahedral8(const float* in, int32_t inStride, int8_t* out, int32_t outStride, int32_t count)
+{
+	EncodeOctahedral(in, inStride, out, outStride, count, 127.0f);
+}
+
+void ispc::DecodeOctahedral8(const int8_t* in, int32_t inStride, float* out, int32_t outStride, int32_t count)
+{
+	DecodeOctahedral(in, inStride, out, outStride, count, 127.0f);
+}
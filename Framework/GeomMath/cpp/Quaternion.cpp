@@ -0,0 +1,133 @@
+#include <math.h>
+#include "Quaternion.h"
+
+// Portable build of ispc/Quaternion.ispc, used when ISPC is not available.
+
+namespace {
+	inline void Blend(const float* a, const float* b, float wa, float wb, bool normalize, float* result)
+	{
+		float r[4];
+		for (int k = 0; k < 4; k++)
+			r[k] = a[k] * wa + b[k] * wb;
+		float scale = normalize ? 1.0f / sqrtf(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]) : 1.0f;
+		for (int k = 0; k < 4; k++)
+			result[k] = r[k] * scale;
+	}
+
+	inline float Dot4(const float* a, const float* b)
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+	}
+
+	// v + w * c + r x c, c = 2 * (r x v)
+	inline void Rotate(const float* r, const float* v, float* result)
+	{
+		float cx = 2 * (r[1] * v[2] - r[2] * v[1]);
+		float cy = 2 * (r[2] * v[0] - r[0] * v[2]);
+		float cz = 2 * (r[0] * v[1] - r[1] * v[0]);
+		result[0] = v[0] + r[3] * cx + (r[1] * cz - r[2] * cy);
+		result[1] = v[1] + r[3] * cy + (r[2] * cx - r[0] * cz);
+		result[2] = v[2] + r[3] * cz + (r[0] * cy - r[1] * cx);
+	}
+}
+
+void ispc::QuaternionSlerp(const float* a, const float* b, float t, float* result, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		const float* qa = a + i * 4;
+		const float* qb = b + i * 4;
+		float d = Dot4(qa, qb);
+		float sign = d < 0 ? -1.0f : 1.0f;
+		d *= sign;
+
+		if (d > 0.9995f) {
+			Blend(qa, qb, 1.0f - t, t * sign, true, result + i * 4);
+		} else {
+			float theta = acosf(d);
+			float inv = 1.0f / sinf(theta);
+			Blend(qa, qb, sinf((1.0f - t) * theta) * inv, sinf(t * theta) * inv * sign, false, result + i * 4);
+		}
+	}
+}
+
+void ispc::QuaternionNlerp(const float* a, const float* b, float t, float* result, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		const float* qa = a + i * 4;
+		const float* qb = b + i * 4;
+		Blend(qa, qb, 1.0f - t, Dot4(qa, qb) < 0 ? -t : t, true, result + i * 4);
+	}
+}
+
+void ispc::QuaternionsToMatrices(const float* q, float* result, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		float x = q[i * 4], y = q[i * 4 + 1], z = q[i * 4 + 2], w = q[i * 4 + 3];
+		float xx = x * x, yy = y * y, zz = z * z;
+		float xy = x * y, xz = x * z, yz = y * z;
+		float wx = w * x, wy = w * y, wz = w * z;
+
+		float* m = result + i * 16;
+		m[0]  = 1 - 2 * (yy + zz); m[1]  = 2 * (xy + wz);     m[2]  = 2 * (xz - wy);     m[3]  = 0;
+		m[4]  = 2 * (xy - wz);     m[5]  = 1 - 2 * (xx + zz); m[6]  = 2 * (yz + wx);     m[7]  = 0;
+		m[8]  = 2 * (xz + wy);     m[9]  = 2 * (yz - wx);     m[10] = 1 - 2 * (xx + yy); m[11] = 0;
+		m[12] = 0;                 m[13] = 0;                 m[14] = 0;                 m[15] = 1;
+	}
+}
+
+void ispc::DualQuaternionsFromRotationTranslation(const float* q, const float* t, float* result, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		float x = q[i * 4], y = q[i * 4 + 1], z = q[i * 4 + 2], w = q[i * 4 + 3];
+		float tx = t[i * 3], ty = t[i * 3 + 1], tz = t[i * 3 + 2];
+
+		float* d = result + i * 8;
+		d[0] = x; d[1] = y; d[2] = z; d[3] = w;
+		d[4] = 0.5f * (tx * w + ty * z - tz * y);
+		d[5] = 0.5f * (-tx * z + ty * w + tz * x);
+		d[6] = 0.5f * (tx * y - ty * x + tz * w);
+		d[7] = -0.5f * (tx * x + ty * y + tz * z);
+	}
+}
+
+void ispc::SkinDualQuaternions(const float* dq, const uint16_t* bones, const float* weights,
+	const float* in, int32_t inStride, float* out, int32_t outStride,
+	int32_t normalOffset, int32_t count)
+{
+	for (int32_t i = 0; i < count; i++) {
+		const float* pivot = dq + bones[i * 4] * 8;
+
+		float blend[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		for (int k = 0; k < 4; k++) {
+			const float* b = dq + bones[i * 4 + k] * 8;
+			float w = weights[i * 4 + k];
+			if (Dot4(b, pivot) < 0) w = -w;
+			for (int j = 0; j < 8; j++)
+				blend[j] += b[j] * w;
+		}
+
+		float inv = 1.0f / sqrtf(Dot4(blend, blend));
+		for (int j = 0; j < 8; j++)
+			blend[j] *= inv;
+		const float* r = blend;
+		const float* d = blend + 4;
+
+		float tx = 2 * (r[3] * d[0] - d[3] * r[0] + r[1] * d[2] - r[2] * d[1]);
+		float ty = 2 * (r[3] * d[1] - d[3] * r[1] + r[2] * d[0] - r[0] * d[2]);
+		float tz = 2 * (r[3] * d[2] - d[3] * r[2] + r[0] * d[1] - r[1] * d[0]);
+
+		const float* v = in + i * inStride;
+		float* o = out + i * outStride;
+		float p[3];
+		Rotate(r, v, p);
+
+		if (normalOffset >= 0) {
+			float n[3];
+			Rotate(r, v + normalOffset, n);
+			o[normalOffset] = n[0]; o[normalOffset + 1] = n[1]; o[normalOffset + 2] = n[2];
+		}
+		o[0] = p[0] + tx;
+		o[1] = p[1] + ty;
+		o[2] = p[2] + tz;
+	}
+}
@@ -0,0 +1,54 @@
+#include <limits>
+#include "Reduction.h"
+
+// Portable build of ispc/Reduction.ispc, used when ISPC is not available.
+
+void ispc::ArraySum(const float* a, float* result, int32_t count)
+{
+	float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	int32_t body = count & ~3;
+	for (int32_t i = 0; i < body; i += 4) {
+		sum[0] += a[i];
+		sum[1] += a[i + 1];
+		sum[2] += a[i + 2];
+		sum[3] += a[i + 3];
+	}
+	for (int32_t i = body; i < count; i++) {
+		sum[0] += a[i];
+	}
+	*result = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+void ispc::ArrayLengthSquared(const float* a, float* result, int32_t count)
+{
+	float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	int32_t body = count & ~3;
+	for (int32_t i = 0; i < body; i += 4) {
+		sum[0] += a[i] * a[i];
+		sum[1] += a[i + 1] * a[i + 1];
+		sum[2] += a[i + 2] * a[i + 2];
+		sum[3] += a[i + 3] * a[i + 3];
+	}
+	for (int32_t i = body; i < count; i++) {
+		sum[0] += a[i] * a[i];
+	}
+	*result = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+void ispc::ArrayMin(const float* a, float* result, int32_t count)
+{
+	float m = std::numeric_limits<float>::infinity();
+	for (int32_t i = 0; i < count; i++) {
+		m = a[i] < m ? a[i] : m;
+	}
+	*result = m;
+}
+
+void ispc::ArrayMax(const float* a, float* result, int32_t count)
+{
+	float m = -std::numeric_limits<float>::infinity();
+	for (int32_t i = 0; i < count; i++) {
+		m = a[i] > m ? a[i] : m;
+	}
+	*result = m;
+}
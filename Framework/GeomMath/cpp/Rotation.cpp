@@ -0,0 +1,112 @@
+#include <math.h>
+#include "Rotation.h"
+
+// Portable build of ispc/Rotation.ispc, used when ISPC is not available.
+// Same reduction and polynomials, so both builds give the same results.
+
+namespace {
+	inline void SinCosReduced(float x, bool accurate, float& s, float& c)
+	{
+		int q = (int)nearbyintf(x * 0.63661977236758134f);
+		float fq = (float)q;
+		float r = ((x - fq * 1.5703125f) - fq * 4.837512969970703125e-4f) - fq * 7.54978995489188216e-8f;
+		float r2 = r * r;
+
+		float ps, pc;
+		if (accurate) {
+			ps = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+			pc = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+		} else {
+			ps = r * (1.0f + r2 * (-1.6666667e-1f + r2 * 8.3333333e-3f));
+			pc = 1.0f + r2 * (-0.5f + r2 * 4.1666667e-2f);
+		}
+
+		int quadrant = q & 3;
+		s = (quadrant & 1) ? pc : ps;
+		c = (quadrant & 1) ? ps : pc;
+		if (quadrant == 1 || quadrant == 2) c = -c;
+		if (quadrant >= 2) s = -s;
+	}
+
+	inline void YawPitchRoll(float yaw, float pitch, float roll, bool accurate, float* m)
+	{
+		float sYaw, cYaw, sPitch, cPitch, sRoll, cRoll;
+		SinCosReduced(yaw, accurate, sYaw, cYaw);
+		SinCosReduced(pitch, accurate, sPitch, cPitch);
+		SinCosReduced(roll, accurate, sRoll, cRoll);
+
+		m[0] = (cRoll * cYaw) + (sRoll * sPitch * sYaw);
+		m[1] = (sRoll * cPitch);
+		m[2] = (cRoll * -sYaw) + (sRoll * sPitch * cYaw);
+
+		m[3] = (-sRoll * cYaw) + (cRoll * sPitch * sYaw);
+		m[4] = (cRoll * cPitch);
+		m[5] = (sRoll * sYaw) + (cRoll * sPitch * cYaw);
+
+		m[6] = (cPitch * sYaw);
+		m[7] = -sPitch;
+		m[8] = (cPitch * cYaw);
+	}
+}
+
+void ispc::SinCos(const float* angles, float* s, float* c, int32_t count, bool accurate)
+{
+	for (int32_t i = 0; i < count; i++) {
+		SinCosReduced(angles[i], accurate, s[i], c[i]);
+	}
+}
+
+void ispc::BuildAxisRotationMatrices(const float* angles, int32_t axis, float* result, int32_t count, bool accurate)
+{
+	for (int32_t i = 0; i < count; i++) {
+		float s, c;
+		SinCosReduced(angles[i], accurate, s, c);
+
+		float* m = result + i * 16;
+		for (int k = 0; k < 16; k++) {
+			m[k] = (k % 5 == 0) ? 1.0f : 0.0f;
+		}
+		if (axis == 0) {
+			m[5] = c;  m[6] = s;
+			m[9] = -s; m[10] = c;
+		} else if (axis == 1) {
+			m[0] = c; m[2] = -s;
+			m[8] = s; m[10] = c;
+		} else {
+			m[0] = c; m[1] = -s;
+			m[4] = s; m[5] = c;
+		}
+	}
+}
+
+void ispc::BuildYawPitchRollMatrices(const float* yaw, const float* pitch, const float* roll,
+	float* result, int32_t count, bool accurate)
+{
+	for (int32_t i = 0; i < count; i++) {
+		YawPitchRoll(yaw[i], pitch[i], roll[i], accurate, result + i * 9);
+	}
+}
+
+void ispc::BuildTRSMatrices(const float* px, const float* py, const float* pz,
+	const float* yaw, const float* pitch, const float* roll,
+	const float* sx, const float* sy, const float* sz,
+	float* result, int32_t count, bool accurate)
+{
+	for (int32_t i = 0; i < count; i++) {
+		float m[9];
+		YawPitchRoll(yaw[i], pitch[i], roll[i], accurate, m);
+
+		const float scale[3] = { sx[i], sy[i], sz[i] };
+		float* out = result + i * 16;
+		for (int r = 0; r < 3; r++) {
+			out[r * 4]     = m[r * 3] * scale[r];
+			out[r * 4 + 1] = m[r * 3 + 1] * scale[r];
+			out[r * 4 + 2] = m[r * 3 + 2] * scale[r];
+			out[r * 4 + 3] = 0.0f;
+		}
+		out[12] = px[i];
+		out[13] = py[i];
+		out[14] = pz[i];
+		out[15] = 1.0f;
+	}
+}
@@ -0,0 +1,159 @@
+#include <math.h>
+#include "Transform.h"
+
+// Portable build of ispc/Transform.ispc, used when ISPC is not available.
+// The loops are written so the compiler can vectorize them: matrix
+// elements are hoisted into locals and every element is independent.
+
+namespace {
+	inline float InverseLength(float x, float y, float z)
+	{
+		float lengthSq = x * x + y * y + z * z;
+		return lengthSq > 0.0f ? 1.0f / sqrtf(lengthSq) : 0.0f;
+	}
+}
+
+void ispc::TransformCoordsSoA(const float* m, const float* x, const float* y, const float* z,
+	float* ox, float* oy, float* oz, int32_t count)
+{
+	const float m00 = m[0], m01 = m[1], m02 = m[2];
+	const float m10 = m[3], m11 = m[4], m12 = m[5];
+	const float m20 = m[6], m21 = m[7], m22 = m[8];
+
+	for (int32_t i = 0; i < count; i++) {
+		float vx = x[i], vy = y[i], vz = z[i];
+		ox[i] = vx * m00 + vy * m10 + vz * m20;
+		oy[i] = vx * m01 + vy * m11 + vz * m21;
+		oz[i] = vx * m02 + vy * m12 + vz * m22;
+	}
+}
+
+void ispc::TransformPointsSoA(const float* m, const float* x, const float* y, const float* z,
+	float* ox, float* oy, float* oz, int32_t count)
+{
+	const float m00 = m[0],  m01 = m[1],  m02 = m[2];
+	const float m10 = m[4],  m11 = m[5],  m12 = m[6];
+	const float m20 = m[8],  m21 = m[9],  m22 = m[10];
+	const float m30 = m[12], m31 = m[13], m32 = m[14];
+
+	for (int32_t i = 0; i < count; i++) {
+		float vx = x[i], vy = y[i], vz = z[i];
+		ox[i] = vx * m00 + vy * m10 + vz * m20 + m30;
+		oy[i] = vx * m01 + vy * m11 + vz * m21 + m31;
+		oz[i] = vx * m02 + vy * m12 + vz * m22 + m32;
+	}
+}
+
+void ispc::TransformPoints4SoA(const float* m, const float* x, const float* y, const float* z,
+	float* ox, float* oy, float* oz, float* ow, int32_t count)
+{
+	const float m00 = m[0],  m01 = m[1],  m02 = m[2],  m03 = m[3];
+	const float m10 = m[4],  m11 = m[5],  m12 = m[6],  m13 = m[7];
+	const float m20 = m[8],  m21 = m[9],  m22 = m[10], m23 = m[11];
+	const float m30 = m[12], m31 = m[13], m32 = m[14], m33 = m[15];
+
+	for (int32_t i = 0; i < count; i++) {
+		float vx = x[i], vy = y[i], vz = z[i];
+		ox[i] = vx * m00 + vy * m10 + vz * m20 + m30;
+		oy[i] = vx * m01 + vy * m11 + vz * m21 + m31;
+		oz[i] = vx * m02 + vy * m12 + vz * m22 + m32;
+		ow[i] = vx * m03 + vy * m13 + vz * m23 + m33;
+	}
+}
+
+void ispc::TransformNormalsSoA(const float* m, const float* x, const float* y, const float* z,
+	float* ox, float* oy, float* oz, int32_t count)
+{
+	const float m00 = m[0], m01 = m[1], m02 = m[2];
+	const float m10 = m[3], m11 = m[4], m12 = m[5];
+	const float m20 = m[6], m21 = m[7], m22 = m[8];
+
+	for (int32_t i = 0; i < count; i++) {
+		float vx = x[i], vy = y[i], vz = z[i];
+		float nx = vx * m00 + vy * m10 + vz * m20;
+		float ny = vx * m01 + vy * m11 + vz * m21;
+		float nz = vx * m02 + vy * m12 + vz * m22;
+		float scale = InverseLength(nx, ny, nz);
+		ox[i] = nx * scale;
+		oy[i] = ny * scale;
+		oz[i] = nz * scale;
+	}
+}
+
+void ispc::TransformCoordsAoS(const float* m, const float* in, int32_t inStride,
+	float* out, int32_t outStride, int32_t count)
+{
+	const float m00 = m[0], m01 = m[1], m02 = m[2];
+	const float m10 = m[3], m11 = m[4], m12 = m[5];
+	const float m20 = m[6], m21 = m[7], m22 = m[8];
+
+	for (int32_t i = 0; i < count; i++) {
+		const float* s = in + i * inStride;
+		float* d = out + i * outStride;
+		float vx = s[0], vy = s[1], vz = s[2];
+		d[0] = vx * m00 + vy * m10 + vz * m20;
+		d[1] = vx * m01 + vy * m11 + vz * m21;
+		d[2] = vx * m02 + vy * m12 + vz * m22;
+	}
+}
+
+void ispc::TransformPointsAoS(const float* m, const float* in, int32_t inStride,
+	float* out, int32_t outStride, int32_t count)
+{
+	const float m00 = m[0],  m01 = m[1],  m02 = m[2];
+	const float m10 = m[4],  m11 = m[5],  m12 = m[6];
+	const float m20 = m[8],  m21 = m[9],  m22 = m[10];
+	const float m30 = m[12], m31 = m[13], m32 = m[14];
+
+	for (int32_t i = 0; i < count; i++) {
+		const float* s = in + i * inStride;
+		float* d = out + i * outStride;
+		float vx = s[0], vy = s[1], vz = s[2];
+		d[0] = vx * m00 + vy * m10 + vz * m20 + m30;
+		d[1] = vx * m01 + vy * m11 + vz * m21 + m31;
+		d[2] = vx * m02 + vy * m12 + vz * m22 + m32;
+	}
+}
+
+void ispc::TransformNormalsAoS(const float* m, const float* in, int32_t inStride,
+	float* out, int32_t outStride, int32_t count)
+{
+	const float m00 = m[0], m01 = m[1], m02 = m[2];
+	const float m10 = m[3], m11 = m[4], m12 = m[5];
+	const float m20 = m[6], m21 = m[7], m22 = m[8];
+
+	for (int32_t i = 0; i < count; i++) {
+		const float* s = in + i * inStride;
+		float* d = out + i * outStride;
+		float vx = s[0], vy = s[1], vz = s[2];
+		float nx = vx * m00 + vy * m10 + vz * m20;
+		float ny = vx * m01 + vy * m11 + vz * m21;
+		float nz = vx * m02 + vy * m12 + vz * m22;
+		float scale = InverseLength(nx, ny, nz);
+		d[0] = nx * scale;
+		d[1] = ny * scale;
+		d[2] = nz * scale;
+	}
+}
+
+void ispc::TransformTangentsAoS(const float* m, const float* in, int32_t inStride,
+	float* out, int32_t outStride, int32_t count)
+{
+	const float m00 = m[0], m01 = m[1], m02 = m[2];
+	const float m10 = m[3], m11 = m[4], m12 = m[5];
+	const float m20 = m[6], m21 = m[7], m22 = m[8];
+
+	for (int32_t i = 0; i < count; i++) {
+		const float* s = in + i * inStride;
+		float* d = out + i * outStride;
+		float vx = s[0], vy = s[1], vz = s[2], vw = s[3];
+		float tx = vx * m00 + vy * m10 + vz * m20;
+		float ty = vx * m01 + vy * m11 + vz * m21;
+		float tz = vx * m02 + vy * m12 + vz * m22;
+		float scale = InverseLength(tx, ty, tz);
+		d[0] = tx * scale;
+		d[1] = ty * scale;
+		d[2] = tz * scale;
+		d[3] = vw;
+	}
+}
@@ -0,0 +1,22 @@
+#include "Transpose.h"
+
+// Portable build of ispc/Transpose.ispc, used when ISPC is not available.
+
+namespace {
+	const int32_t kTile = 32;
+}
+
+void ispc::Transpose(float* a, float* r, int32_t row_count, int32_t column_count)
+{
+	for (int32_t i0 = 0; i0 < row_count; i0 += kTile) {
+		int32_t i1 = i0 + kTile < row_count ? i0 + kTile : row_count;
+		for (int32_t j0 = 0; j0 < column_count; j0 += kTile) {
+			int32_t j1 = j0 + kTile < column_count ? j0 + kTile : column_count;
+			for (int32_t j = j0; j < j1; j++) {
+				for (int32_t i = i0; i < i1; i++) {
+					r[j * row_count + i] = a[i * column_count + j];
+				}
+			}
+		}
+	}
+}
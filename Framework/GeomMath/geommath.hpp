@@ -1,24 +1,97 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if !defined(MY_GEOMMATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MY_GEOMMATH_SSE 1
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define MY_GEOMMATH_AVX 1
+#include <immintrin.h>
+#endif
+#endif
+
+#ifndef PI
+#define PI 3.14159265358979323846f
+#endif
+
+#ifndef TWO_PI
+#define TWO_PI 3.14159265358979323846f * 2.0f
+#endif
 
 namespace My {
+    /// Sine, cosine and tangent usable in constant expressions, for tables
+    /// and fixed angles that should fold at compile time. Evaluated in double
+    /// by Taylor series after reducing the angle to [-pi, pi]; much slower
+    /// than std::sin when called at runtime.
+    constexpr double ConstexprSin(double x) {
+        const double kPi = 3.14159265358979323846;
+        long long turns = static_cast<long long>(x / (2.0 * kPi) + (x >= 0.0 ? 0.5 : -0.5));
+        x -= 2.0 * kPi * static_cast<double>(turns);
+
+        double term = x, sum = x;
+        for (int k = 1; k < 16; k++) {
+            term *= -x * x / ((2 * k) * (2 * k + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double ConstexprCos(double x) {
+        return ConstexprSin(x + 3.14159265358979323846 * 0.5);
+    }
+
+    constexpr double ConstexprTan(double x) {
+        return ConstexprSin(x) / ConstexprCos(x);
+    }
+
+    template<typename T> struct Vector2Type;
+    template<typename T> struct Vector3Type;
+    template<typename T> struct Vector4Type;
 
-    template<typename T, int ... Indexes>
+    template<typename T, int N> struct VectorOf;
+    template<typename T> struct VectorOf<T, 2> { typedef Vector2Type<T> type; };
+    template<typename T> struct VectorOf<T, 3> { typedef Vector3Type<T> type; };
+    template<typename T> struct VectorOf<T, 4> { typedef Vector4Type<T> type; };
+
+    /// Named view of some components of an N-component vector, e.g. v.zyx.
+    /// It shares the vector's storage through a union, so reading it is a
+    /// plain component gather and writing it a scatter, with no extra
+    /// memory. Index lists must not repeat a component.
+    template<typename T, int N, int... Indexes>
     class swizzle {
-        float v[sizeof...(Indexes)];
+        T v[N];
+
+    public:
+        typedef typename VectorOf<T, sizeof...(Indexes)>::type result_type;
+
+        operator result_type() const {
+            return result_type(v[Indexes]...);
+        }
 
-        public:
-        T& operator=(const T& rhs) {
-            int indexes[] = { Indexes... };
-            for (int i = 0; i < sizeof...(Indexes); i++) {
+        swizzle& operator=(const result_type& rhs) {
+            const int indexes[] = { Indexes... };
+            for (size_t i = 0; i < sizeof...(Indexes); i++) {
                 v[indexes[i]] = rhs[i];
             }
-            return *(T*)this;
+            return *this;
         }
 
-        operator T() const {
-            return T(v[Indexes]...)
+        // a.xy = b.xy must only write x and y, not the whole array
+        swizzle& operator=(const swizzle& rhs) {
+            return *this = static_cast<result_type>(rhs);
         }
     };
 
+    // The vector types declare their copy assignment because their swizzle
+    // members have a component-wise one; copy construction stays trivial.
+    // Everything except the uninitialized default constructor is constexpr,
+    // and constant expressions only touch 'data', the member constructors
+    // initialize: reading x or a swizzle there would read an inactive union
+    // member, which the compiler rejects.
 
     template<typename T>
     struct Vector2Type {
@@ -27,12 +100,1043 @@ namespace My {
             struct { T x, y; };
             struct { T r, g; };
             struct { T u, v; };
-            swizzle<Vector2Type<T>, 0, 1> xy;
-            swizzle<Vector2Type<T>, 1, 0> yx;
-        }
+            swizzle<T, 2, 0, 1> xy;
+            swizzle<T, 2, 1, 0> yx;
+        };
 
         Vector2Type() {};
-        Vector2Type(float _v) : x(_v), y(_v) {};
-        Vector2Type(float _v, float _u) : x(_v), y(_u) {};
+        Vector2Type(const Vector2Type& rhs) = default;
+        explicit constexpr Vector2Type(T _v) : data{ _v, _v } {};
+        constexpr Vector2Type(T _x, T _y) : data{ _x, _y } {};
+
+        constexpr Vector2Type& operator=(const Vector2Type& rhs) {
+            data[0] = rhs.data[0]; data[1] = rhs.data[1];
+            return *this;
+        }
+
+        constexpr T& operator[](size_t i) { return data[i]; }
+        constexpr const T& operator[](size_t i) const { return data[i]; }
+    };
+
+    template<typename T>
+    struct Vector3Type {
+        union {
+            T data[3];
+            struct { T x, y, z; };
+            struct { T r, g, b; };
+            swizzle<T, 3, 0, 1> xy;
+            swizzle<T, 3, 1, 0> yx;
+            swizzle<T, 3, 0, 2> xz;
+            swizzle<T, 3, 2, 0> zx;
+            swizzle<T, 3, 1, 2> yz;
+            swizzle<T, 3, 2, 1> zy;
+            swizzle<T, 3, 0, 1, 2> xyz;
+            swizzle<T, 3, 0, 2, 1> xzy;
+            swizzle<T, 3, 1, 0, 2> yxz;
+            swizzle<T, 3, 1, 2, 0> yzx;
+            swizzle<T, 3, 2, 0, 1> zxy;
+            swizzle<T, 3, 2, 1, 0> zyx;
+        };
+
+        Vector3Type() {};
+        Vector3Type(const Vector3Type& rhs) = default;
+        explicit constexpr Vector3Type(T _v) : data{ _v, _v, _v } {};
+        constexpr Vector3Type(T _x, T _y, T _z) : data{ _x, _y, _z } {};
+        constexpr Vector3Type(const Vector2Type<T>& _xy, T _z) : data{ _xy.data[0], _xy.data[1], _z } {};
+
+        constexpr Vector3Type& operator=(const Vector3Type& rhs) {
+            data[0] = rhs.data[0]; data[1] = rhs.data[1]; data[2] = rhs.data[2];
+            return *this;
+        }
+
+        constexpr T& operator[](size_t i) { return data[i]; }
+        constexpr const T& operator[](size_t i) const { return data[i]; }
     };
-}
\ No newline at end of file
+
+    /// Four components aligned to their full width, so float vectors map
+    /// to one SSE register with aligned loads and stores.
+    template<typename T>
+    struct alignas(sizeof(T) * 4) Vector4Type {
+        union {
+            T data[4];
+            struct { T x, y, z, w; };
+            struct { T r, g, b, a; };
+            swizzle<T, 4, 0, 1> xy;
+            swizzle<T, 4, 2, 3> zw;
+            swizzle<T, 4, 0, 1, 2> xyz;
+            swizzle<T, 4, 1, 2, 0> yzx;
+            swizzle<T, 4, 2, 0, 1> zxy;
+            swizzle<T, 4, 2, 1, 0> zyx;
+            swizzle<T, 4, 0, 1, 2> rgb;
+            swizzle<T, 4, 2, 1, 0> bgr;
+            swizzle<T, 4, 0, 1, 2, 3> xyzw;
+            swizzle<T, 4, 3, 2, 1, 0> wzyx;
+            swizzle<T, 4, 2, 1, 0, 3> bgra;
+        };
+
+        Vector4Type() {};
+        Vector4Type(const Vector4Type& rhs) = default;
+        explicit constexpr Vector4Type(T _v) : data{ _v, _v, _v, _v } {};
+        constexpr Vector4Type(T _x, T _y, T _z, T _w) : data{ _x, _y, _z, _w } {};
+        constexpr Vector4Type(const Vector3Type<T>& _xyz, T _w) : data{ _xyz.data[0], _xyz.data[1], _xyz.data[2], _w } {};
+
+        constexpr Vector4Type& operator=(const Vector4Type& rhs) {
+            data[0] = rhs.data[0]; data[1] = rhs.data[1];
+            data[2] = rhs.data[2]; data[3] = rhs.data[3];
+            return *this;
+        }
+
+        constexpr T& operator[](size_t i) { return data[i]; }
+        constexpr const T& operator[](size_t i) const { return data[i]; }
+    };
+
+    typedef Vector2Type<float> Vector2f;
+    typedef Vector3Type<float> Vector3f;
+    typedef Vector4Type<float> Vector4f;
+    typedef Vector4Type<uint8_t> R8G8B8A8Unorm;
+
+    // component-wise arithmetic, generic form. The helpers expand over the
+    // component indexes instead of looping, so every operation is a single
+    // constexpr expression, fully unrolled whatever the optimizer decides.
+    // Only the vector templates have an N; returning VectorResult makes
+    // other single-parameter templates (quaternions, caller types) drop
+    // out of overload resolution instead of failing inside these bodies.
+    template<template<typename> class TT, typename T>
+    struct VectorTraits {};
+    template<typename T> struct VectorTraits<Vector2Type, T> { enum { N = 2 }; };
+    template<typename T> struct VectorTraits<Vector3Type, T> { enum { N = 3 }; };
+    template<typename T> struct VectorTraits<Vector4Type, T> { enum { N = 4 }; };
+
+    template<template<typename> class TT, typename T, typename R = TT<T>>
+    using VectorResult = std::enable_if_t<(VectorTraits<TT, T>::N > 0), R>;
+
+    namespace detail {
+        template<template<typename> class TT, typename T>
+        using VectorIndexes = std::make_index_sequence<VectorTraits<TT, T>::N>;
+
+        template<template<typename> class TT, typename T, typename Op, size_t... I>
+        constexpr TT<T> Apply(const TT<T>& a, const TT<T>& b, Op op, std::index_sequence<I...>) {
+            return TT<T>(op(a.data[I], b.data[I])...);
+        }
+
+        template<template<typename> class TT, typename T, typename Op, size_t... I>
+        constexpr TT<T> Apply(const TT<T>& a, T s, Op op, std::index_sequence<I...>) {
+            return TT<T>(op(a.data[I], s)...);
+        }
+
+        template<template<typename> class TT, typename T, size_t... I>
+        constexpr TT<T> Negate(const TT<T>& a, std::index_sequence<I...>) {
+            return TT<T>(-a.data[I]...);
+        }
+
+        /// Sum of a[i] * b[i] for i < N, unrolled by recursion on N; adds in
+        /// index order like the loop it replaces.
+        template<int N>
+        struct Dot {
+            template<typename V>
+            static constexpr auto Apply(const V& a, const V& b) -> decltype(a.data[0] * b.data[0]) {
+                return Dot<N - 1>::Apply(a, b) + a.data[N - 1] * b.data[N - 1];
+            }
+        };
+
+        template<>
+        struct Dot<1> {
+            template<typename V>
+            static constexpr auto Apply(const V& a, const V& b) -> decltype(a.data[0] * b.data[0]) {
+                return a.data[0] * b.data[0];
+            }
+        };
+
+        struct Add { template<typename T> constexpr T operator()(T a, T b) const { return a + b; } };
+        struct Subtract { template<typename T> constexpr T operator()(T a, T b) const { return a - b; } };
+        struct Multiply { template<typename T> constexpr T operator()(T a, T b) const { return a * b; } };
+        struct Divide { template<typename T> constexpr T operator()(T a, T b) const { return a / b; } };
+    }
+
+#define MY_GEOMMATH_VECTOR_OPERATOR(op, Op) \
+    template<template<typename> class TT, typename T> \
+    constexpr VectorResult<TT, T> operator op(const TT<T>& a, const TT<T>& b) { \
+        return detail::Apply(a, b, detail::Op(), detail::VectorIndexes<TT, T>()); \
+    } \
+    template<template<typename> class TT, typename T> \
+    constexpr VectorResult<TT, T> operator op(const TT<T>& a, T s) { \
+        return detail::Apply(a, s, detail::Op(), detail::VectorIndexes<TT, T>()); \
+    } \
+    template<template<typename> class TT, typename T> \
+    constexpr VectorResult<TT, T, TT<T>&> operator op##=(TT<T>& a, const TT<T>& b) { \
+        for (int i = 0; i < VectorTraits<TT, T>::N; i++) a.data[i] op##= b.data[i]; \
+        return a; \
+    }
+
+    MY_GEOMMATH_VECTOR_OPERATOR(+, Add)
+    MY_GEOMMATH_VECTOR_OPERATOR(-, Subtract)
+    MY_GEOMMATH_VECTOR_OPERATOR(*, Multiply)
+    MY_GEOMMATH_VECTOR_OPERATOR(/, Divide)
+
+#undef MY_GEOMMATH_VECTOR_OPERATOR
+
+    template<template<typename> class TT, typename T>
+    constexpr VectorResult<TT, T> operator-(const TT<T>& a) {
+        return detail::Negate(a, detail::VectorIndexes<TT, T>());
+    }
+
+    template<template<typename> class TT, typename T>
+    constexpr VectorResult<TT, T> operator*(T s, const TT<T>& a) {
+        return a * s;
+    }
+
+    template<template<typename> class TT, typename T>
+    constexpr VectorResult<TT, T, T> DotProduct(const TT<T>& a, const TT<T>& b) {
+        return detail::Dot<VectorTraits<TT, T>::N>::Apply(a, b);
+    }
+
+    template<template<typename> class TT, typename T>
+    constexpr VectorResult<TT, T> MulByElement(const TT<T>& a, const TT<T>& b) {
+        return a * b;
+    }
+
+    template<template<typename> class TT, typename T>
+    constexpr VectorResult<TT, T, T> LengthSquared(const TT<T>& a) {
+        return DotProduct(a, a);
+    }
+
+    template<template<typename> class TT, typename T>
+    inline VectorResult<TT, T, T> Length(const TT<T>& a) {
+        return std::sqrt(LengthSquared(a));
+    }
+
+    template<template<typename> class TT, typename T>
+    inline VectorResult<TT, T> Normalize(const TT<T>& a) {
+        T length = Length(a);
+        return length > 0 ? a * (T(1) / length) : a;
+    }
+
+    template<typename T>
+    constexpr Vector3Type<T> CrossProduct(const Vector3Type<T>& a, const Vector3Type<T>& b) {
+        return Vector3Type<T>(
+            a.data[1] * b.data[2] - a.data[2] * b.data[1],
+            a.data[2] * b.data[0] - a.data[0] * b.data[2],
+            a.data[0] * b.data[1] - a.data[1] * b.data[0]);
+    }
+
+#if defined(MY_GEOMMATH_SSE)
+    // packed overloads for the 4-wide float vector; ordinary functions win
+    // over the templates above during overload resolution
+
+    inline __m128 Load(const Vector4f& v) { return _mm_load_ps(v.data); }
+    inline void Store(Vector4f& v, __m128 m) { _mm_store_ps(v.data, m); }
+
+    inline Vector4f operator+(const Vector4f& a, const Vector4f& b) {
+        Vector4f result; Store(result, _mm_add_ps(Load(a), Load(b))); return result;
+    }
+    inline Vector4f operator-(const Vector4f& a, const Vector4f& b) {
+        Vector4f result; Store(result, _mm_sub_ps(Load(a), Load(b))); return result;
+    }
+    inline Vector4f operator*(const Vector4f& a, const Vector4f& b) {
+        Vector4f result; Store(result, _mm_mul_ps(Load(a), Load(b))); return result;
+    }
+    inline Vector4f operator/(const Vector4f& a, const Vector4f& b) {
+        Vector4f result; Store(result, _mm_div_ps(Load(a), Load(b))); return result;
+    }
+    inline Vector4f operator*(const Vector4f& a, float s) {
+        Vector4f result; Store(result, _mm_mul_ps(Load(a), _mm_set1_ps(s))); return result;
+    }
+    inline Vector4f operator*(float s, const Vector4f& a) {
+        return a * s;
+    }
+    inline Vector4f& operator+=(Vector4f& a, const Vector4f& b) {
+        Store(a, _mm_add_ps(Load(a), Load(b))); return a;
+    }
+    inline Vector4f& operator-=(Vector4f& a, const Vector4f& b) {
+        Store(a, _mm_sub_ps(Load(a), Load(b))); return a;
+    }
+    inline Vector4f& operator*=(Vector4f& a, const Vector4f& b) {
+        Store(a, _mm_mul_ps(Load(a), Load(b))); return a;
+    }
+    inline Vector4f operator-(const Vector4f& a) {
+        Vector4f result; Store(result, _mm_xor_ps(Load(a), _mm_set1_ps(-0.0f))); return result;
+    }
+
+    inline float DotProduct(const Vector4f& a, const Vector4f& b) {
+        __m128 m = _mm_mul_ps(Load(a), Load(b));
+        __m128 s = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        s = _mm_add_ss(s, _mm_movehl_ps(s, s));
+        return _mm_cvtss_f32(s);
+    }
+
+    inline Vector4f MulByElement(const Vector4f& a, const Vector4f& b) {
+        return a * b;
+    }
+#endif
+
+    /// Row-major matrix used with row vectors (v' = v * M), the same
+    /// convention as Direct3D and the original vectormath.h helpers.
+    /// Constant matrices are built from all ROWS * COLS elements in row
+    /// order; in constant expressions they are read through 'flat', the
+    /// member that constructor initializes.
+    template<typename T, int ROWS, int COLS>
+    struct alignas(COLS == 4 ? sizeof(T) * 4 : alignof(T)) Matrix {
+        union {
+            T data[ROWS][COLS];
+            T flat[ROWS * COLS];
+        };
+
+        Matrix() {};
+
+        template<typename... Values, typename = typename std::enable_if<sizeof...(Values) == ROWS * COLS>::type>
+        constexpr Matrix(Values... values) : flat{ T(values)... } {};
+
+        T* operator[](int row) { return data[row]; }
+        const T* operator[](int row) const { return data[row]; }
+    };
+
+    typedef Matrix<float, 3, 3> Matrix3X3f;
+    typedef Matrix<float, 4, 4> Matrix4X4f;
+
+    // The value-returning matrix operations are constexpr and expanded over
+    // the element indexes like the vector ones. The out-parameter forms
+    // (Transpose(result, m), MatrixMultiply) stay the runtime entry points
+    // and take the SSE path for 4x4 floats below.
+
+    namespace detail {
+        template<typename T, int ROWS, int COLS, typename Op, size_t... I>
+        constexpr Matrix<T, ROWS, COLS> Apply(const Matrix<T, ROWS, COLS>& a, const Matrix<T, ROWS, COLS>& b,
+            Op op, std::index_sequence<I...>) {
+            return Matrix<T, ROWS, COLS>(op(a.flat[I], b.flat[I])...);
+        }
+
+        // element I of the COLS x ROWS result is m[I % ROWS][I / ROWS]
+        template<typename T, int ROWS, int COLS, size_t... I>
+        constexpr Matrix<T, COLS, ROWS> Transpose(const Matrix<T, ROWS, COLS>& m, std::index_sequence<I...>) {
+            return Matrix<T, COLS, ROWS>(m.flat[(I % ROWS) * COLS + I / ROWS]...);
+        }
+
+        /// Row i of a times column j of b, the first N terms, in k order.
+        template<int N>
+        struct RowColumn {
+            template<typename T, int ROWS, int K, int COLS>
+            static constexpr T Apply(const Matrix<T, ROWS, K>& a, const Matrix<T, K, COLS>& b, int i, int j) {
+                return RowColumn<N - 1>::Apply(a, b, i, j) + a.flat[i * K + N - 1] * b.flat[(N - 1) * COLS + j];
+            }
+        };
+
+        template<>
+        struct RowColumn<1> {
+            template<typename T, int ROWS, int K, int COLS>
+            static constexpr T Apply(const Matrix<T, ROWS, K>& a, const Matrix<T, K, COLS>& b, int i, int j) {
+                return a.flat[i * K] * b.flat[j];
+            }
+        };
+
+        template<typename T, int ROWS, int K, int COLS, size_t... I>
+        constexpr Matrix<T, ROWS, COLS> Multiply(const Matrix<T, ROWS, K>& a, const Matrix<T, K, COLS>& b,
+            std::index_sequence<I...>) {
+            return Matrix<T, ROWS, COLS>(RowColumn<K>::Apply(a, b, int(I) / COLS, int(I) % COLS)...);
+        }
+
+        template<typename T, int N, size_t... I>
+        constexpr Matrix<T, N, N> Identity(std::index_sequence<I...>) {
+            return Matrix<T, N, N>((I % (N + 1) == 0 ? T(1) : T(0))...);
+        }
+    }
+
+    template<typename T, int ROWS, int COLS>
+    constexpr Matrix<T, ROWS, COLS> operator+(const Matrix<T, ROWS, COLS>& a, const Matrix<T, ROWS, COLS>& b) {
+        return detail::Apply(a, b, detail::Add(), std::make_index_sequence<ROWS * COLS>());
+    }
+
+    template<typename T, int ROWS, int COLS>
+    constexpr Matrix<T, ROWS, COLS> operator-(const Matrix<T, ROWS, COLS>& a, const Matrix<T, ROWS, COLS>& b) {
+        return detail::Apply(a, b, detail::Subtract(), std::make_index_sequence<ROWS * COLS>());
+    }
+
+    template<typename T, int ROWS, int COLS>
+    constexpr Matrix<T, COLS, ROWS> Transpose(const Matrix<T, ROWS, COLS>& m) {
+        return detail::Transpose(m, std::make_index_sequence<ROWS * COLS>());
+    }
+
+    template<typename T, int ROWS, int COLS>
+    inline void Transpose(Matrix<T, COLS, ROWS>& result, const Matrix<T, ROWS, COLS>& m) {
+        result = Transpose(m);
+    }
+
+    template<typename T, int ROWS, int K, int COLS>
+    constexpr Matrix<T, ROWS, COLS> operator*(const Matrix<T, ROWS, K>& a, const Matrix<T, K, COLS>& b) {
+        return detail::Multiply(a, b, std::make_index_sequence<ROWS * COLS>());
+    }
+
+    template<typename T, int ROWS, int K, int COLS>
+    inline void MatrixMultiply(Matrix<T, ROWS, COLS>& result, const Matrix<T, ROWS, K>& a, const Matrix<T, K, COLS>& b) {
+        result = a * b;
+    }
+
+#if defined(MY_GEOMMATH_SSE)
+    // each result row is a linear combination of the rows of b
+    inline __m128 MatrixRowMultiply(const float* row, const Matrix4X4f& b) {
+        __m128 r = _mm_mul_ps(_mm_set1_ps(row[0]), _mm_load_ps(b.data[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[1]), _mm_load_ps(b.data[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[2]), _mm_load_ps(b.data[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[3]), _mm_load_ps(b.data[3])));
+        return r;
+    }
+
+#if defined(MY_GEOMMATH_AVX)
+    // two result rows per 256-bit register: each 128-bit lane broadcasts
+    // the elements of its row of a against the rows of b
+    inline void MatrixMultiply(Matrix4X4f& result, const Matrix4X4f& a, const Matrix4X4f& b) {
+        __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.data[0]));
+        __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.data[1]));
+        __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.data[2]));
+        __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.data[3]));
+        // matrices are 16-byte aligned, so the row pairs are loaded unaligned
+        __m256 a01 = _mm256_loadu_ps(a.data[0]);
+        __m256 a23 = _mm256_loadu_ps(a.data[2]);
+
+        // compute both halves before storing, result may alias a or b
+        __m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3));
+        __m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0);
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xAA), b2));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xFF), b3));
+        _mm256_storeu_ps(result.data[0], r01);
+        _mm256_storeu_ps(result.data[2], r23);
+    }
+#else
+    inline void MatrixMultiply(Matrix4X4f& result, const Matrix4X4f& a, const Matrix4X4f& b) {
+        // compute all rows before storing, result may alias a or b
+        __m128 r0 = MatrixRowMultiply(a.data[0], b);
+        __m128 r1 = MatrixRowMultiply(a.data[1], b);
+        __m128 r2 = MatrixRowMultiply(a.data[2], b);
+        __m128 r3 = MatrixRowMultiply(a.data[3], b);
+        _mm_store_ps(result.data[0], r0);
+        _mm_store_ps(result.data[1], r1);
+        _mm_store_ps(result.data[2], r2);
+        _mm_store_ps(result.data[3], r3);
+    }
+#endif
+
+    inline void Transpose(Matrix4X4f& result, const Matrix4X4f& m) {
+        __m128 r0 = _mm_load_ps(m.data[0]);
+        __m128 r1 = _mm_load_ps(m.data[1]);
+        __m128 r2 = _mm_load_ps(m.data[2]);
+        __m128 r3 = _mm_load_ps(m.data[3]);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_store_ps(result.data[0], r0);
+        _mm_store_ps(result.data[1], r1);
+        _mm_store_ps(result.data[2], r2);
+        _mm_store_ps(result.data[3], r3);
+    }
+#endif
+
+    /// v' = v * M with the 3x3 matrix.
+    template<typename T>
+    inline void TransformCoord(Vector3Type<T>& vector, const Matrix<T, 3, 3>& matrix) {
+        Vector3Type<T> v = vector;
+        for (int j = 0; j < 3; j++) {
+            vector.data[j] = v.x * matrix.data[0][j] + v.y * matrix.data[1][j] + v.z * matrix.data[2][j];
+        }
+    }
+
+    /// v' = v * M with the 4x4 matrix.
+    template<typename T>
+    inline void Transform(Vector4Type<T>& vector, const Matrix<T, 4, 4>& matrix) {
+        Vector4Type<T> v = vector;
+        for (int j = 0; j < 4; j++) {
+            vector.data[j] = v.x * matrix.data[0][j] + v.y * matrix.data[1][j]
+                + v.z * matrix.data[2][j] + v.w * matrix.data[3][j];
+        }
+    }
+
+#if defined(MY_GEOMMATH_SSE)
+    inline void Transform(Vector4f& vector, const Matrix4X4f& matrix) {
+        Store(vector, MatrixRowMultiply(vector.data, matrix));
+    }
+#endif
+
+    /// Point transform (w = 1) by a 4x4 matrix, without the perspective divide.
+    template<typename T>
+    inline Vector3Type<T> TransformPoint(const Vector3Type<T>& p, const Matrix<T, 4, 4>& matrix) {
+        Vector4Type<T> v(p, T(1));
+        Transform(v, matrix);
+        return Vector3Type<T>(v.x, v.y, v.z);
+    }
+
+    /// Direction transform (w = 0) by a 4x4 matrix.
+    template<typename T>
+    inline Vector3Type<T> TransformVector(const Vector3Type<T>& d, const Matrix<T, 4, 4>& matrix) {
+        Vector4Type<T> v(d, T(0));
+        Transform(v, matrix);
+        return Vector3Type<T>(v.x, v.y, v.z);
+    }
+
+    template<typename T, int N>
+    constexpr Matrix<T, N, N> IdentityMatrix() {
+        return detail::Identity<T, N>(std::make_index_sequence<N * N>());
+    }
+
+    template<typename T, int N>
+    inline void BuildIdentityMatrix(Matrix<T, N, N>& matrix) {
+        matrix = IdentityMatrix<T, N>();
+    }
+
+    inline void MatrixRotationYawPitchRoll(Matrix3X3f& matrix, float yaw, float pitch, float roll) {
+        float cYaw = cosf(yaw), sYaw = sinf(yaw);
+        float cPitch = cosf(pitch), sPitch = sinf(pitch);
+        float cRoll = cosf(roll), sRoll = sinf(roll);
+
+        matrix.data[0][0] = (cRoll * cYaw) + (sRoll * sPitch * sYaw);
+        matrix.data[0][1] = (sRoll * cPitch);
+        matrix.data[0][2] = (cRoll * -sYaw) + (sRoll * sPitch * cYaw);
+
+        matrix.data[1][0] = (-sRoll * cYaw) + (cRoll * sPitch * sYaw);
+        matrix.data[1][1] = (cRoll * cPitch);
+        matrix.data[1][2] = (sRoll * sYaw) + (cRoll * sPitch * cYaw);
+
+        matrix.data[2][0] = (cPitch * sYaw);
+        matrix.data[2][1] = -sPitch;
+        matrix.data[2][2] = (cPitch * cYaw);
+    }
+
+    inline void MatrixRotationYawPitchRoll(Matrix4X4f& matrix, float yaw, float pitch, float roll) {
+        Matrix3X3f rotation;
+        MatrixRotationYawPitchRoll(rotation, yaw, pitch, roll);
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) matrix.data[i][j] = rotation.data[i][j];
+            matrix.data[i][3] = 0.0f;
+        }
+        matrix.data[3][0] = 0.0f; matrix.data[3][1] = 0.0f; matrix.data[3][2] = 0.0f; matrix.data[3][3] = 1.0f;
+    }
+
+    inline void MatrixRotationX(Matrix4X4f& matrix, float angle) {
+        float c = cosf(angle), s = sinf(angle);
+        BuildIdentityMatrix(matrix);
+        matrix.data[1][1] = c;  matrix.data[1][2] = s;
+        matrix.data[2][1] = -s; matrix.data[2][2] = c;
+    }
+
+    inline void MatrixRotationY(Matrix4X4f& matrix, float angle) {
+        float c = cosf(angle), s = sinf(angle);
+        BuildIdentityMatrix(matrix);
+        matrix.data[0][0] = c; matrix.data[0][2] = -s;
+        matrix.data[2][0] = s; matrix.data[2][2] = c;
+    }
+
+    inline void MatrixRotationZ(Matrix4X4f& matrix, float angle) {
+        float c = cosf(angle), s = sinf(angle);
+        BuildIdentityMatrix(matrix);
+        matrix.data[0][0] = c; matrix.data[0][1] = -s;
+        matrix.data[1][0] = s; matrix.data[1][1] = c;
+    }
+
+    inline void MatrixTranslation(Matrix4X4f& matrix, float x, float y, float z) {
+        BuildIdentityMatrix(matrix);
+        matrix.data[3][0] = x;
+        matrix.data[3][1] = y;
+        matrix.data[3][2] = z;
+    }
+
+    inline void MatrixScale(Matrix4X4f& matrix, float x, float y, float z) {
+        BuildIdentityMatrix(matrix);
+        matrix.data[0][0] = x;
+        matrix.data[1][1] = y;
+        matrix.data[2][2] = z;
+    }
+
+    inline void BuildViewMatrix(Matrix4X4f& result, const Vector3f& position, const Vector3f& lookAt, const Vector3f& up) {
+        Vector3f zAxis = Normalize(lookAt - position);
+        Vector3f xAxis = Normalize(CrossProduct(up, zAxis));
+        Vector3f yAxis = CrossProduct(zAxis, xAxis);
+
+        result.data[0][0] = xAxis.x; result.data[0][1] = yAxis.x; result.data[0][2] = zAxis.x; result.data[0][3] = 0.0f;
+        result.data[1][0] = xAxis.y; result.data[1][1] = yAxis.y; result.data[1][2] = zAxis.y; result.data[1][3] = 0.0f;
+        result.data[2][0] = xAxis.z; result.data[2][1] = yAxis.z; result.data[2][2] = zAxis.z; result.data[2][3] = 0.0f;
+
+        result.data[3][0] = -DotProduct(xAxis, position);
+        result.data[3][1] = -DotProduct(yAxis, position);
+        result.data[3][2] = -DotProduct(zAxis, position);
+        result.data[3][3] = 1.0f;
+    }
+
+    namespace detail {
+        constexpr Matrix4X4f PerspectiveLH(float yScale, float screenAspect, float screenNear, float screenDepth) {
+            return Matrix4X4f(
+                yScale / screenAspect, 0.0f, 0.0f, 0.0f,
+                0.0f, yScale, 0.0f, 0.0f,
+                0.0f, 0.0f, screenDepth / (screenDepth - screenNear), 1.0f,
+                0.0f, 0.0f, (-screenNear * screenDepth) / (screenDepth - screenNear), 0.0f);
+        }
+    }
+
+    inline void BuildPerspectiveFovLHMatrix(Matrix4X4f& matrix, float fieldOfView, float screenAspect, float screenNear, float screenDepth) {
+        matrix = detail::PerspectiveLH(1.0f / tanf(fieldOfView * 0.5f), screenAspect, screenNear, screenDepth);
+    }
+
+    /// The same projection for a field of view known at compile time, e.g.
+    /// constexpr Matrix4X4f kProjection = PerspectiveFovLHMatrix(PI / 4.0f, ...).
+    /// The tangent comes from ConstexprTan, so call it from constant
+    /// expressions only; BuildPerspectiveFovLHMatrix is the runtime form.
+    constexpr Matrix4X4f PerspectiveFovLHMatrix(float fieldOfView, float screenAspect, float screenNear, float screenDepth) {
+        return detail::PerspectiveLH(float(1.0 / ConstexprTan(fieldOfView * 0.5)), screenAspect, screenNear, screenDepth);
+    }
+
+    /// True when column 3 is (0, 0, 0, 1), i.e. no projection: the matrix
+    /// is a 3x3 linear part followed by a translation in row 3.
+    template<typename T>
+    inline bool IsAffine(const Matrix<T, 4, 4>& m) {
+        return m.data[0][3] == T(0) && m.data[1][3] == T(0) && m.data[2][3] == T(0) && m.data[3][3] == T(1);
+    }
+
+    /// Returns false and leaves result alone when m is singular.
+    template<typename T>
+    inline bool InverseMatrix(Matrix<T, 3, 3>& result, const Matrix<T, 3, 3>& m) {
+        const T (*a)[3] = m.data;
+        T c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+        T c01 = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+        T c02 = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+        T det = a[0][0] * c00 + a[0][1] * c01 + a[0][2] * c02;
+        if (det == T(0))
+            return false;
+
+        T inv = T(1) / det;
+        T r[3][3] = {
+            { c00 * inv, (a[0][2] * a[2][1] - a[0][1] * a[2][2]) * inv, (a[0][1] * a[1][2] - a[0][2] * a[1][1]) * inv },
+            { c01 * inv, (a[0][0] * a[2][2] - a[0][2] * a[2][0]) * inv, (a[0][2] * a[1][0] - a[0][0] * a[1][2]) * inv },
+            { c02 * inv, (a[0][1] * a[2][0] - a[0][0] * a[2][1]) * inv, (a[0][0] * a[1][1] - a[0][1] * a[1][0]) * inv },
+        };
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                result.data[i][j] = r[i][j];
+        return true;
+    }
+
+    /// Inverse of an affine matrix (see IsAffine): the 3x3 part is inverted
+    /// and the translation brought back through it, about a third of the
+    /// work of the general inverse.
+    template<typename T>
+    inline bool InverseAffineMatrix(Matrix<T, 4, 4>& result, const Matrix<T, 4, 4>& m) {
+        Matrix<T, 3, 3> linear;
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                linear.data[i][j] = m.data[i][j];
+        if (!InverseMatrix(linear, linear))
+            return false;
+
+        T t[3] = { m.data[3][0], m.data[3][1], m.data[3][2] };
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) result.data[i][j] = linear.data[i][j];
+            result.data[i][3] = T(0);
+        }
+        for (int j = 0; j < 3; j++)
+            result.data[3][j] = -(t[0] * linear.data[0][j] + t[1] * linear.data[1][j] + t[2] * linear.data[2][j]);
+        result.data[3][3] = T(1);
+        return true;
+    }
+
+    /// Inverse of a rotation followed by a translation, such as a view or
+    /// camera matrix: transpose the rotation, rotate the translation back.
+    /// The caller guarantees there is no scale.
+    template<typename T>
+    inline void InverseRigidMatrix(Matrix<T, 4, 4>& result, const Matrix<T, 4, 4>& m) {
+        T r[3][3], t[3] = { m.data[3][0], m.data[3][1], m.data[3][2] };
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                r[i][j] = m.data[j][i];
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) result.data[i][j] = r[i][j];
+            result.data[i][3] = T(0);
+        }
+        for (int j = 0; j < 3; j++)
+            result.data[3][j] = -(t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j]);
+        result.data[3][3] = T(1);
+    }
+
+    /// General inverse by cofactors. Affine matrices take the cheaper
+    /// InverseAffineMatrix path. Returns false and leaves result alone when
+    /// m is singular.
+    template<typename T>
+    inline bool InverseMatrix(Matrix<T, 4, 4>& result, const Matrix<T, 4, 4>& m) {
+        if (IsAffine(m))
+            return InverseAffineMatrix(result, m);
+
+        const T* a = m.flat;
+        // 2x2 determinants of the upper two and the lower two rows
+        T s0 = a[0] * a[5] - a[4] * a[1];
+        T s1 = a[0] * a[6] - a[4] * a[2];
+        T s2 = a[0] * a[7] - a[4] * a[3];
+        T s3 = a[1] * a[6] - a[5] * a[2];
+        T s4 = a[1] * a[7] - a[5] * a[3];
+        T s5 = a[2] * a[7] - a[6] * a[3];
+        T c5 = a[10] * a[15] - a[14] * a[11];
+        T c4 = a[9] * a[15] - a[13] * a[11];
+        T c3 = a[9] * a[14] - a[13] * a[10];
+        T c2 = a[8] * a[15] - a[12] * a[11];
+        T c1 = a[8] * a[14] - a[12] * a[10];
+        T c0 = a[8] * a[13] - a[12] * a[9];
+
+        T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (det == T(0))
+            return false;
+        T inv = T(1) / det;
+
+        T r[16] = {
+            ( a[5] * c5 - a[6] * c4 + a[7] * c3) * inv,
+            (-a[1] * c5 + a[2] * c4 - a[3] * c3) * inv,
+            ( a[13] * s5 - a[14] * s4 + a[15] * s3) * inv,
+            (-a[9] * s5 + a[10] * s4 - a[11] * s3) * inv,
+
+            (-a[4] * c5 + a[6] * c2 - a[7] * c1) * inv,
+            ( a[0] * c5 - a[2] * c2 + a[3] * c1) * inv,
+            (-a[12] * s5 + a[14] * s2 - a[15] * s1) * inv,
+            ( a[8] * s5 - a[10] * s2 + a[11] * s1) * inv,
+
+            ( a[4] * c4 - a[5] * c2 + a[7] * c0) * inv,
+            (-a[0] * c4 + a[1] * c2 - a[3] * c0) * inv,
+            ( a[12] * s4 - a[13] * s2 + a[15] * s0) * inv,
+            (-a[8] * s4 + a[9] * s2 - a[11] * s0) * inv,
+
+            (-a[4] * c3 + a[5] * c1 - a[6] * c0) * inv,
+            ( a[0] * c3 - a[1] * c1 + a[2] * c0) * inv,
+            (-a[12] * s3 + a[13] * s1 - a[14] * s0) * inv,
+            ( a[8] * s3 - a[9] * s1 + a[10] * s0) * inv,
+        };
+        for (int i = 0; i < 16; i++)
+            result.flat[i] = r[i];
+        return true;
+    }
+
+#if defined(MY_GEOMMATH_SSE)
+    namespace detail {
+        // 2x2 blocks held row-major in one register: (m00, m01, m10, m11)
+        inline __m128 Swizzle(__m128 v, int mask) {
+            return _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), mask));
+        }
+
+        // A * B
+        inline __m128 Mat2Mul(__m128 a, __m128 b) {
+            return _mm_add_ps(_mm_mul_ps(a, Swizzle(b, _MM_SHUFFLE(3, 0, 3, 0))),
+                _mm_mul_ps(Swizzle(a, _MM_SHUFFLE(2, 3, 0, 1)), Swizzle(b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+
+        // adj(A) * B
+        inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+            return _mm_sub_ps(_mm_mul_ps(Swizzle(a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+                _mm_mul_ps(Swizzle(a, _MM_SHUFFLE(2, 2, 1, 1)), Swizzle(b, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+
+        // A * adj(B)
+        inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+            return _mm_sub_ps(_mm_mul_ps(a, Swizzle(b, _MM_SHUFFLE(0, 3, 0, 3))),
+                _mm_mul_ps(Swizzle(a, _MM_SHUFFLE(2, 3, 0, 1)), Swizzle(b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+    }
+
+    /// Same contract as the generic InverseMatrix; the general case is done
+    /// blockwise on 2x2 sub-matrices held in one register each.
+    inline bool InverseMatrix(Matrix4X4f& result, const Matrix4X4f& m) {
+        using namespace detail;
+
+        if (IsAffine(m))
+            return InverseAffineMatrix(result, m);
+
+        __m128 r0 = _mm_load_ps(m.data[0]), r1 = _mm_load_ps(m.data[1]);
+        __m128 r2 = _mm_load_ps(m.data[2]), r3 = _mm_load_ps(m.data[3]);
+
+        // M = | A B |
+        //     | C D |
+        __m128 A = _mm_movelh_ps(r0, r1);
+        __m128 B = _mm_movehl_ps(r1, r0);
+        __m128 C = _mm_movelh_ps(r2, r3);
+        __m128 D = _mm_movehl_ps(r3, r2);
+
+        // (|A|, |B|, |C|, |D|)
+        __m128 detSub = _mm_sub_ps(
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+        __m128 detA = Swizzle(detSub, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 detB = Swizzle(detSub, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 detC = Swizzle(detSub, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 detD = Swizzle(detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+        __m128 D_C = Mat2AdjMul(D, C);
+        __m128 A_B = Mat2AdjMul(A, B);
+        // adjugates of the result blocks, scaled by |M|
+        __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, D_C));
+        __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, A_B));
+        __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, A_B));
+        __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, D_C));
+
+        // |M| = |A||D| + |B||C| - tr(adj(A) B adj(D) C)
+        __m128 tr = _mm_mul_ps(A_B, Swizzle(D_C, _MM_SHUFFLE(3, 1, 2, 0)));
+        tr = _mm_add_ps(tr, Swizzle(tr, _MM_SHUFFLE(2, 3, 0, 1)));
+        tr = _mm_add_ps(tr, Swizzle(tr, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+        if (_mm_cvtss_f32(detM) == 0.0f)
+            return false;
+
+        __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+        X = _mm_mul_ps(X, rDetM);
+        Y = _mm_mul_ps(Y, rDetM);
+        Z = _mm_mul_ps(Z, rDetM);
+        W = _mm_mul_ps(W, rDetM);
+
+        // undo the adjugates while interleaving the blocks back into rows
+        _mm_store_ps(result.data[0], _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(result.data[1], _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_store_ps(result.data[2], _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(result.data[3], _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0, 2, 0, 2)));
+        return true;
+    }
+#endif
+
+    /// Normal matrix: inverse transpose of the 3x3 part of m, which keeps
+    /// normals perpendicular to surfaces under non-uniform scale. Computed
+    /// as the cofactor matrix over the determinant; returns false when the
+    /// 3x3 part is singular.
+    template<typename T>
+    inline bool InverseTransposeMatrix(Matrix<T, 3, 3>& result, const Matrix<T, 4, 4>& m) {
+        Matrix<T, 3, 3> linear;
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                linear.data[i][j] = m.data[i][j];
+        if (!InverseMatrix(linear, linear))
+            return false;
+        Transpose(result, linear);
+        return true;
+    }
+
+    /// Axis-aligned box.
+    struct AABB {
+        Vector3f minimum;
+        Vector3f maximum;
+
+        Vector3f Center() const { return (minimum + maximum) * 0.5f; }
+        Vector3f Extent() const { return (maximum - minimum) * 0.5f; }
+    };
+
+    struct BoundingSphere {
+        Vector3f center;
+        float    radius;
+    };
+
+    /// Six inward-facing planes (a, b, c, d): a point p is inside a plane
+    /// when a*p.x + b*p.y + c*p.z + d >= 0. Order: left, right, bottom,
+    /// top, near, far. Stored as 24 contiguous floats for the kernels.
+    struct Frustum {
+        Vector4f planes[6];
+    };
+
+    /// Planes of the clip volume of 'matrix' (e.g. view * projection from
+    /// BuildViewMatrix/BuildPerspectiveFovLHMatrix), in the space the
+    /// matrix transforms from. Uses the D3D depth range 0 <= z <= w.
+    inline void ExtractFrustumPlanes(Frustum& frustum, const Matrix4X4f& matrix)
+    {
+        // with row vectors, clip.x = dot(v, column 0) and so on
+        for (int i = 0; i < 4; i++) {
+            float c0 = matrix.data[i][0], c1 = matrix.data[i][1];
+            float c2 = matrix.data[i][2], c3 = matrix.data[i][3];
+            frustum.planes[0].data[i] = c3 + c0;
+            frustum.planes[1].data[i] = c3 - c0;
+            frustum.planes[2].data[i] = c3 + c1;
+            frustum.planes[3].data[i] = c3 - c1;
+            frustum.planes[4].data[i] = c2;
+            frustum.planes[5].data[i] = c3 - c2;
+        }
+
+        // unit normals, so plane distances compare with sphere radii
+        for (int p = 0; p < 6; p++) {
+            Vector4f& plane = frustum.planes[p];
+            float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            if (length > 0.0f) plane = plane * (1.0f / length);
+        }
+    }
+
+    inline bool IsVisible(const Frustum& frustum, const BoundingSphere& sphere)
+    {
+        for (int p = 0; p < 6; p++) {
+            const Vector4f& plane = frustum.planes[p];
+            float distance = plane.x * sphere.center.x + plane.y * sphere.center.y + plane.z * sphere.center.z + plane.w;
+            if (distance < -sphere.radius) return false;
+        }
+        return true;
+    }
+
+    /// Conservative: boxes crossing two planes outside a frustum corner pass.
+    inline bool IsVisible(const Frustum& frustum, const AABB& box)
+    {
+        Vector3f center = box.Center();
+        Vector3f extent = box.Extent();
+        for (int p = 0; p < 6; p++) {
+            const Vector4f& plane = frustum.planes[p];
+            float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            float radius = std::fabs(plane.x) * extent.x + std::fabs(plane.y) * extent.y + std::fabs(plane.z) * extent.z;
+            if (distance < -radius) return false;
+        }
+        return true;
+    }
+
+    /// Unit quaternion rotation, (x, y, z) vector part and w scalar part.
+    template<typename T>
+    struct alignas(sizeof(T) * 4) QuaternionType {
+        union {
+            T data[4];
+            struct { T x, y, z, w; };
+            Vector4Type<T> xyzw;
+        };
+
+        QuaternionType() {};
+        QuaternionType(const QuaternionType& rhs) = default;
+        constexpr QuaternionType(T _x, T _y, T _z, T _w) : data{ _x, _y, _z, _w } {};
+
+        constexpr QuaternionType& operator=(const QuaternionType& rhs) {
+            data[0] = rhs.data[0]; data[1] = rhs.data[1];
+            data[2] = rhs.data[2]; data[3] = rhs.data[3];
+            return *this;
+        }
+
+        static constexpr QuaternionType Identity() { return QuaternionType(0, 0, 0, 1); }
+
+        /// Rotation of 'angle' radians about the unit vector 'axis'.
+        static QuaternionType FromAxisAngle(const Vector3Type<T>& axis, T angle) {
+            T s = std::sin(angle * T(0.5));
+            return QuaternionType(axis.x * s, axis.y * s, axis.z * s, std::cos(angle * T(0.5)));
+        }
+    };
+
+    typedef QuaternionType<float> Quaternion;
+
+    /// Hamilton product: applying the result rotates by b, then by a.
+    template<typename T>
+    constexpr QuaternionType<T> operator*(const QuaternionType<T>& a, const QuaternionType<T>& b) {
+        return QuaternionType<T>(
+            a.data[3] * b.data[0] + a.data[0] * b.data[3] + a.data[1] * b.data[2] - a.data[2] * b.data[1],
+            a.data[3] * b.data[1] - a.data[0] * b.data[2] + a.data[1] * b.data[3] + a.data[2] * b.data[0],
+            a.data[3] * b.data[2] + a.data[0] * b.data[1] - a.data[1] * b.data[0] + a.data[2] * b.data[3],
+            a.data[3] * b.data[3] - a.data[0] * b.data[0] - a.data[1] * b.data[1] - a.data[2] * b.data[2]);
+    }
+
+    template<typename T>
+    constexpr QuaternionType<T> Conjugate(const QuaternionType<T>& q) {
+        return QuaternionType<T>(-q.data[0], -q.data[1], -q.data[2], q.data[3]);
+    }
+
+    template<typename T>
+    constexpr T DotProduct(const QuaternionType<T>& a, const QuaternionType<T>& b) {
+        return a.data[0] * b.data[0] + a.data[1] * b.data[1] + a.data[2] * b.data[2] + a.data[3] * b.data[3];
+    }
+
+    template<typename T>
+    inline QuaternionType<T> Normalize(const QuaternionType<T>& q) {
+        T length = std::sqrt(DotProduct(q, q));
+        T inv = length > 0 ? T(1) / length : T(0);
+        return QuaternionType<T>(q.x * inv, q.y * inv, q.z * inv, q.w * inv);
+    }
+
+    /// Normalized linear blend along the shorter arc. Cheaper than Slerp and
+    /// close to it for the small angles between neighbouring key frames.
+    template<typename T>
+    inline QuaternionType<T> Nlerp(const QuaternionType<T>& a, const QuaternionType<T>& b, T t) {
+        T wb = DotProduct(a, b) < 0 ? -t : t;
+        T wa = T(1) - t;
+        return Normalize(QuaternionType<T>(a.x * wa + b.x * wb, a.y * wa + b.y * wb,
+            a.z * wa + b.z * wb, a.w * wa + b.w * wb));
+    }
+
+    /// Constant angular velocity blend along the shorter arc.
+    template<typename T>
+    inline QuaternionType<T> Slerp(const QuaternionType<T>& a, const QuaternionType<T>& b, T t) {
+        T d = DotProduct(a, b);
+        T sign = d < 0 ? T(-1) : T(1);
+        d *= sign;
+        if (d > T(0.9995))
+            return Nlerp(a, b, t);
+
+        T theta = std::acos(d);
+        T inv = T(1) / std::sin(theta);
+        T wa = std::sin((T(1) - t) * theta) * inv;
+        T wb = std::sin(t * theta) * inv * sign;
+        return QuaternionType<T>(a.x * wa + b.x * wb, a.y * wa + b.y * wb,
+            a.z * wa + b.z * wb, a.w * wa + b.w * wb);
+    }
+
+    /// Rotates v by the unit quaternion q.
+    template<typename T>
+    inline Vector3Type<T> Rotate(const QuaternionType<T>& q, const Vector3Type<T>& v) {
+        // v' = v + 2w(u x v) + 2u x (u x v), u = q.xyz
+        Vector3Type<T> u(q.x, q.y, q.z);
+        Vector3Type<T> t = CrossProduct(u, v) * T(2);
+        return v + t * q.w + CrossProduct(u, t);
+    }
+
+    /// Rotation matrix for row vectors, so that v * M == Rotate(q, v).
+    template<typename T>
+    inline void MatrixRotationQuaternion(Matrix<T, 3, 3>& m, const QuaternionType<T>& q) {
+        T xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        T xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        T wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        m.data[0][0] = 1 - 2 * (yy + zz); m.data[0][1] = 2 * (xy + wz);     m.data[0][2] = 2 * (xz - wy);
+        m.data[1][0] = 2 * (xy - wz);     m.data[1][1] = 1 - 2 * (xx + zz); m.data[1][2] = 2 * (yz + wx);
+        m.data[2][0] = 2 * (xz + wy);     m.data[2][1] = 2 * (yz - wx);     m.data[2][2] = 1 - 2 * (xx + yy);
+    }
+
+    template<typename T>
+    inline void MatrixRotationQuaternion(Matrix<T, 4, 4>& m, const QuaternionType<T>& q) {
+        Matrix<T, 3, 3> r;
+        MatrixRotationQuaternion(r, q);
+        BuildIdentityMatrix(m);
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                m.data[i][j] = r.data[i][j];
+    }
+
+    /// Rigid transform as a unit dual quaternion: rotation 'real', and
+    /// dual = 0.5 * (t, 0) * real for the translation t. Blending dual
+    /// quaternions and renormalizing keeps the result rigid, which is why
+    /// skinning uses them instead of blended matrices.
+    template<typename T>
+    struct DualQuaternionType {
+        QuaternionType<T> real;
+        QuaternionType<T> dual;
+
+        DualQuaternionType() {};
+        DualQuaternionType(const QuaternionType<T>& _real, const QuaternionType<T>& _dual) : real(_real), dual(_dual) {};
+
+        /// Rotation by r followed by translation by t.
+        static DualQuaternionType FromRotationTranslation(const QuaternionType<T>& r, const Vector3Type<T>& t) {
+            QuaternionType<T> d = QuaternionType<T>(t.x, t.y, t.z, 0) * r;
+            return DualQuaternionType(r, QuaternionType<T>(d.x * T(0.5), d.y * T(0.5), d.z * T(0.5), d.w * T(0.5)));
+        }
+
+        Vector3Type<T> Translation() const {
+            QuaternionType<T> t = dual * Conjugate(real);
+            return Vector3Type<T>(t.x * 2, t.y * 2, t.z * 2);
+        }
+    };
+
+    typedef DualQuaternionType<float> DualQuaternion;
+
+    /// Scales both parts so the rotation is a unit quaternion again.
+    template<typename T>
+    inline DualQuaternionType<T> Normalize(const DualQuaternionType<T>& dq) {
+        T length = std::sqrt(DotProduct(dq.real, dq.real));
+        T inv = length > 0 ? T(1) / length : T(0);
+        return DualQuaternionType<T>(
+            QuaternionType<T>(dq.real.x * inv, dq.real.y * inv, dq.real.z * inv, dq.real.w * inv),
+            QuaternionType<T>(dq.dual.x * inv, dq.dual.y * inv, dq.dual.z * inv, dq.dual.w * inv));
+    }
+
+    template<typename T>
+    inline Vector3Type<T> TransformPoint(const Vector3Type<T>& p, const DualQuaternionType<T>& dq) {
+        return Rotate(dq.real, p) + dq.Translation();
+    }
+
+    template<typename T>
+    inline void MatrixRotationTranslation(Matrix<T, 4, 4>& m, const DualQuaternionType<T>& dq) {
+        MatrixRotationQuaternion(m, dq.real);
+        Vector3Type<T> t = dq.Translation();
+        m.data[3][0] = t.x; m.data[3][1] = t.y; m.data[3][2] = t.z;
+    }
+}
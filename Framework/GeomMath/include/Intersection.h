@@ -0,0 +1,52 @@
+//
+// D:/workspace/GameEngineFromScratch/Framework/GeomMath/include/Intersection.h
+// (Header automatically generated by the ispc compiler.)
+// DO NOT EDIT THIS FILE.
+//
+
+#ifndef ISPC_D__WORKSPACE_GAMEENGINEFROMSCRATCH_FRAMEWORK_GEOMMATH_INCLUDE_INTERSECTION_H
+#define ISPC_D__WORKSPACE_GAMEENGINEFROMSCRATCH_FRAMEWORK_GEOMMATH_INCLUDE_INTERSECTION_H
+
+#include <stdint.h>
+
+
+
+#ifdef __cplusplus
+namespace ispc { /* namespace */
+#endif // __cplusplus
+
+#ifndef __ISPC_ALIGN__
+#if defined(__clang__) || !defined(_MSC_VER)
+// Clang, GCC, ICC
+#define __ISPC_ALIGN__(s) __attribute__((aligned(s)))
+#define __ISPC_ALIGNED_STRUCT__(s) struct __ISPC_ALIGN__(s)
+#else
+// Visual Studio
+#define __ISPC_ALIGN__(s) __declspec(align(s))
+#define __ISPC_ALIGNED_STRUCT__(s) __ISPC_ALIGN__(s) struct
+#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////
+// Functions exported from ispc code
+///////////////////////////////////////////////////////////////////////////
+#if defined(__cplusplus) && (! defined(__ISPC_NO_EXTERN_C) || !__ISPC_NO_EXTERN_C )
+extern "C" {
+#endif // __cplusplus
+    extern int32_t IntersectRayAABBs(const float * origin, const float * direction, float tMax, const float * minX, const float * minY, const float * minZ, const float * maxX, const float * maxY, const float * maxZ, int32_t * hits, int32_t count);
+    extern int32_t IntersectRayTriangles16(const float * origin, const float * direction, float tMax, const float * vertices, int32_t vertexStride, const uint16_t * indices, int32_t triangleCount, float * hitT, float * hitU, float * hitV);
+    extern int32_t IntersectRayTriangles32(const float * origin, const float * direction, float tMax, const float * vertices, int32_t vertexStride, const uint32_t * indices, int32_t triangleCount, float * hitT, float * hitU, float * hitV);
+    extern void IntersectRaysAABB(const float * box, float tMax, const float * ox, const float * oy, const float * oz, const float * dx, const float * dy, const float * dz, float * tNear, int32_t rayCount);
+    extern void IntersectRaysTriangles16(const float * vertices, int32_t vertexStride, const uint16_t * indices, int32_t triangleCount, const float * ox, const float * oy, const float * oz, const float * dx, const float * dy, const float * dz, float * tHit, int32_t * hitTriangle, float * hitU, float * hitV, int32_t rayCount);
+    extern void IntersectRaysTriangles32(const float * vertices, int32_t vertexStride, const uint32_t * indices, int32_t triangleCount, const float * ox, const float * oy, const float * oz, const float * dx, const float * dy, const float * dz, float * tHit, int32_t * hitTriangle, float * hitU, float * hitV, int32_t rayCount);
+#if defined(__cplusplus) && (! defined(__ISPC_NO_EXTERN_C) || !__ISPC_NO_EXTERN_C )
+} /* end extern C */
+#endif // __cplusplus
+
+
+#ifdef __cplusplus
+} /* namespace */
+#endif // __cplusplus
+
+#endif // ISPC_D__WORKSPACE_GAMEENGINEFROMSCRATCH_FRAMEWORK_GEOMMATH_INCLUDE_INTERSECTION_H
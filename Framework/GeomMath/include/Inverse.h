@@ -0,0 +1,50 @@
+//
+// D:/workspace/GameEngineFromScratch/Framework/GeomMath/include/Inverse.h
+// (Header automatically generated by the ispc compiler.)
+// DO NOT EDIT THIS FILE.
+//
+
+#ifndef ISPC_D__WORKSPACE_GAMEENGINEFROMSCRATCH_FRAMEWORK_GEOMMATH_INCLUDE_INVERSE_H
+#define ISPC_D__WORKSPACE_GAMEENGINEFROMSCRATCH_FRAMEWORK_GEOMMATH_INCLUDE_INVERSE_H
+
+#include <stdint.h>
+
+
+
+#ifdef __cplusplus
+namespace ispc { /* namespace */
+#endif // __cplusplus
+
+#ifndef __ISPC_ALIGN__
+#if defined(__clang__) || !defined(_MSC_VER)
+// Clang, GCC, ICC
+#define __ISPC_ALIGN__(s) __attribute__((aligned(s)))
+#define __ISPC_ALIGNED_STRUCT__(s) struct __ISPC_ALIGN__(s)
+#else
+// Visual Studio
+#define __ISPC_ALIGN__(s) __declspec(align(s))
+#define __ISPC_ALIGNED_STRUCT__(s) __ISPC_ALIGN__(s) struct
+#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////
+// Functions exported from ispc code
+///////////////////////////////////////////////////////////////////////////
+#if defined(__cplusplus) && (! defined(__ISPC_NO_EXTERN_C) || !__ISPC_NO_EXTERN_C )
+extern "C" {
+#endif // __cplusplus
+    extern int32_t InverseAffineMatrices(const float * a, float * result, int32_t count);
+    extern int32_t InverseMatrices(const float * a, float * result, int32_t count);
+    extern void InverseRigidMatrices(const float * a, float * result, int32_t count);
+    extern int32_t InverseTransposeMatrices(const float * a, float * result, int32_t count);
+#if defined(__cplusplus) && (! defined(__ISPC_NO_EXTERN_C) || !__ISPC_NO_EXTERN_C )
+} /* end extern C */
+#endif // __cplusplus
+
+
+#ifdef __cplusplus
+} /* namespace */
+#endif // __cplusplus
+
+#endif // ISPC_D__WORKSPACE_GAMEENGINEFROMSCRATCH_FRAMEWORK_GEOMMATH_INCLUDE_INVERSE_H
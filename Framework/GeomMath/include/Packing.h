@@ -0,0 +1,60 @@
+//
+// D:/workspace/GameEngineFromScratch/Framework/GeomMath/include/Packing.h
+// (Header automatically generated by the ispc compiler.)
+// DO NOT EDIT THIS FILE.
+//
+
+#ifndef ISPC_D__WORKSPACE_GAMEENGINEFROMSCRATCH_FRAMEWORK_GEOMMATH_INCLUDE_PACKING_H
+#define ISPC_D__WORKSPACE_GAMEENGINEFROMSCRATCH_FRAMEWORK_GEOMMATH_INCLUDE_PACKING_H
+
+#include <stdint.h>
+
+
+
+#ifdef __cplusplus
+namespace ispc { /* namespace */
+#endif // __cplusplus
+
+#ifndef __ISPC_ALIGN__
+#if defined(__clang__) || !defined(_MSC_VER)
+// Clang, GCC, ICC
+#define __ISPC_ALIGN__(s) __attribute__((aligned(s)))
+#define __ISPC_ALIGNED_STRUCT__(s) struct __ISPC_ALIGN__(s)
+#else
+// Visual Studio
+#define __ISPC_ALIGN__(s) __declspec(align(s))
+#define __ISPC_ALIGNED_STRUCT__(s) __ISPC_ALIGN__(s) struct
+#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////
+// Functions exported from ispc code
+///////////////////////////////////////////////////////////////////////////
+#if defined(__cplusplus) && (! defined(__ISPC_NO_EXTERN_C) || !__ISPC_NO_EXTERN_C )
+extern "C" {
+#endif // __cplusplus
+    extern void DecodeOctahedral16(const int16_t * in, int32_t inStride, float * out, int32_t outStride, int32_t count);
+    extern void DecodeOctahedral8(const int8_t * in, int32_t inStride, float * out, int32_t outStride, int32_t count);
+    extern void EncodeOctahedral16(const float * in, int32_t inStride, int16_t * out, int32_t outStride, int32_t count);
+    extern void EncodeOctahedral8(const float * in, int32_t inStride, int8_t * out, int32_t outStride, int32_t count);
+    extern void FloatToHalf(const float * in, int32_t inStride, uint16_t * out, int32_t outStride, int32_t components, int32_t count);
+    extern void FloatToSnorm16(const float * in, int32_t inStride, int16_t * out, int32_t outStride, int32_t components, int32_t count);
+    extern void FloatToSnorm8(const float * in, int32_t inStride, int8_t * out, int32_t outStride, int32_t components, int32_t count);
+    extern void FloatToUnorm16(const float * in, int32_t inStride, uint16_t * out, int32_t outStride, int32_t components, int32_t count);
+    extern void FloatToUnorm8(const float * in, int32_t inStride, uint8_t * out, int32_t outStride, int32_t components, int32_t count);
+    extern void HalfToFloat(const uint16_t * in, int32_t inStride, float * out, int32_t outStride, int32_t components, int32_t count);
+    extern void Snorm16ToFloat(const int16_t * in, int32_t inStride, float * out, int32_t outStride, int32_t components, int32_t count);
+    extern void Snorm8ToFloat(const int8_t * in, int32_t inStride, float * out, int32_t outStride, int32_t components, int32_t count);
+    extern void Unorm16ToFloat(const uint16_t * in, int32_t inStride, float * out, int32_t outStride, int32_t components, int32_t count);
+    extern void Unorm8ToFloat(const uint8_t * in, int32_t inStride, float * out, int32_t outStride, int32_t components, int32_t count);
+#if defined(__cplusplus) && (! defined(__ISPC_NO_EXTERN_C) || !__ISPC_NO_EXTERN_C )
+} /* end extern C */
+#endif // __cplusplus
+
+
+#ifdef __cplusplus
+} /* namespace */
+#endif // __cplusplus
+
+#endif // ISPC_D__WORKSPACE_GAMEENGINEFROMSCRATCH_FRAMEWORK_GEOMMATH_INCLUDE_PACKING_H
@@ -12,6 +12,8 @@ namespace My
 		virtual void Tick() = 0;
 		virtual bool IsQuit() = 0;
 
+		virtual void SetCommandLineParameters(int argc, char** argv) = 0;
+
 		virtual GfxConfiguration& GetConfiguration() = 0;
 	};
 }
\ No newline at end of file
@@ -1,10 +1,16 @@
 #include "BaseApplication.hpp"
-#include "GraphicsManager.hpp"
+#include "Empty/EmptyGraphicsManager.hpp"
 #include "MemoryManager.hpp"
+#include "Profiler.hpp"
+#include "Logger.hpp"
+#include "EventBus.hpp"
 
 namespace My {
     GfxConfiguration config;
 	IApplication*    g_pApp             = static_cast<IApplication*>(new BaseApplication(config));
-    GraphicsManager* g_pGraphicsManager = static_cast<GraphicsManager*>(new GraphicsManager);
+    GraphicsManager* g_pGraphicsManager = static_cast<GraphicsManager*>(new EmptyGraphicsManager);
     MemoryManager*   g_pMemoryManager   = static_cast<MemoryManager*>(new MemoryManager);
+    Profiler*        g_pProfiler        = static_cast<Profiler*>(new Profiler);
+    Logger*          g_pLogger          = static_cast<Logger*>(new Logger);
+    EventBus*        g_pEventBus        = static_cast<EventBus*>(new EventBus);
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "LinuxApplication.hpp"
+#include "PlatformServices.hpp"
+#include "Empty/EmptyGraphicsManager.hpp"
+#include "MemoryManager.hpp"
+#include "Profiler.hpp"
+#include "Logger.hpp"
+#include "EventBus.hpp"
+
+using namespace My;
+
+namespace {
+    void SetupLogThread()
+    {
+        SetCurrentThreadName("LogFlush");
+    }
+}
+
+namespace My {
+    GfxConfiguration config(8, 8, 8, 8, 24, 0, 0, 960, 540, "Game Engine From Scratch (Linux)");
+    IApplication*    g_pApp             = static_cast<IApplication*>(new LinuxApplication(config));
+    GraphicsManager* g_pGraphicsManager = static_cast<GraphicsManager*>(new EmptyGraphicsManager);
+    MemoryManager*   g_pMemoryManager   = static_cast<MemoryManager*>(new MemoryManager);
+    Profiler*        g_pProfiler        = static_cast<Profiler*>(new Profiler);
+    Logger*          g_pLogger          = static_cast<Logger*>(new Logger(SetupLogThread));
+    EventBus*        g_pEventBus        = static_cast<EventBus*>(new EventBus);
+}
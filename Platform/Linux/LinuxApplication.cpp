@@ -0,0 +1,136 @@
+#include <stdlib.h>
+#include "LinuxApplication.hpp"
+#include "PlatformServices.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+
+#if defined(MY_HAVE_X11)
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#endif
+
+using namespace My;
+
+int My::LinuxApplication::Initialize()
+{
+    int result;
+
+    result = BaseApplication::Initialize();
+    if (result != 0) {
+        return result;
+    }
+
+    SetupMainThread();
+
+    m_bHeadless = true;
+    if (!HasCommandLineOption("--headless")) {
+        if (CreateMainWindow() == 0) {
+            m_bHeadless = false;
+        } else {
+            LOG_WARNING("No display available, running headless");
+        }
+    }
+
+    return result;
+}
+
+void My::LinuxApplication::Finalize()
+{
+#if defined(MY_HAVE_X11)
+    if (m_pDisplay) {
+        if (m_Window) XDestroyWindow(m_pDisplay, m_Window);
+        XCloseDisplay(m_pDisplay);
+    }
+#endif
+    m_pDisplay = nullptr;
+    m_Window = 0;
+
+    BaseApplication::Finalize();
+}
+
+void My::LinuxApplication::Tick()
+{
+    PROFILE_SCOPE("LinuxApplication::Tick");
+
+#if defined(MY_HAVE_X11)
+    if (!m_pDisplay) return;
+
+    while (XPending(m_pDisplay)) {
+        XEvent event;
+        XNextEvent(m_pDisplay, &event);
+
+        switch (event.type) {
+        case ClientMessage:
+            if (static_cast<unsigned long>(event.xclient.data.l[0]) == m_WmDeleteWindow) {
+                m_bQuit = true;
+            }
+            break;
+        case DestroyNotify:
+            m_bQuit = true;
+            break;
+        default:
+            break;
+        }
+    }
+#endif
+}
+
+void My::LinuxApplication::SetupMainThread()
+{
+    // the main thread keeps its name: renaming it renames the process in
+    // ps, top, pidof and killall
+
+    CpuTopology topology;
+    QueryCpuTopology(topology);
+    LOG_INFO("CPU: %u logical, %u cores, %u packages, L1d %uK L2 %uK L3 %uK, line %u bytes",
+        topology.logicalProcessorCount, topology.physicalCoreCount, topology.packageCount,
+        topology.l1DataCacheSize / 1024, topology.l2CacheSize / 1024, topology.l3CacheSize / 1024,
+        topology.cacheLineSize);
+
+    const char* cpu = GetCommandLineOption("--main-thread-cpu");
+    if (cpu) {
+        uint32_t id = static_cast<uint32_t>(strtoul(cpu, nullptr, 10));
+        if (!SetCurrentThreadAffinity(&id, 1)) {
+            LOG_WARNING("Cannot pin main thread to cpu %u", id);
+        }
+    }
+
+    if (!SetCurrentThreadPriority(kThreadPriorityHigh)) {
+        LOG_INFO("Main thread keeps normal priority (no permission to raise it)");
+    }
+}
+
+int My::LinuxApplication::CreateMainWindow()
+{
+#if defined(MY_HAVE_X11)
+    m_pDisplay = XOpenDisplay(nullptr);
+    if (!m_pDisplay) {
+        return -1;
+    }
+
+    int screen = DefaultScreen(m_pDisplay);
+    m_Window = XCreateSimpleWindow(
+        m_pDisplay,
+        RootWindow(m_pDisplay, screen),
+        0, 0,
+        m_Config.screenWidth, m_Config.screenHeight,
+        0,
+        BlackPixel(m_pDisplay, screen),
+        BlackPixel(m_pDisplay, screen)
+    );
+
+    XStoreName(m_pDisplay, m_Window, m_Config.appName);
+    XSelectInput(m_pDisplay, m_Window, ExposureMask | KeyPressMask | StructureNotifyMask);
+
+    Atom wmDelete = XInternAtom(m_pDisplay, "WM_DELETE_WINDOW", False);
+    XSetWMProtocols(m_pDisplay, m_Window, &wmDelete, 1);
+    m_WmDeleteWindow = wmDelete;
+
+    XMapWindow(m_pDisplay, m_Window);
+    XFlush(m_pDisplay);
+
+    return 0;
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "BaseApplication.hpp"
+
+struct _XDisplay;
+
+namespace My {
+    /// Linux application. Opens an X11 window when built with X11 and a
+    /// display is reachable (this includes XWayland sessions), otherwise
+    /// runs headless. "--headless" forces headless mode, and
+    /// "--main-thread-cpu <n>" pins the main thread to logical cpu n.
+    class LinuxApplication : public BaseApplication
+    {
+    public:
+        LinuxApplication(GfxConfiguration& config)
+            : BaseApplication(config), m_bHeadless(true),
+            m_pDisplay(nullptr), m_Window(0), m_WmDeleteWindow(0) {};
+
+        virtual int Initialize();
+        virtual void Finalize();
+        virtual void Tick();
+
+        inline bool IsHeadless() const { return m_bHeadless; };
+        inline _XDisplay* GetDisplay() { return m_pDisplay; };
+        inline unsigned long GetMainWindow() { return m_Window; };
+
+    private:
+        void SetupMainThread();
+        int CreateMainWindow();
+
+    private:
+        bool m_bHeadless;
+        _XDisplay* m_pDisplay;
+        unsigned long m_Window;         // X11 Window
+        unsigned long m_WmDeleteWindow; // X11 Atom
+    };
+}
@@ -0,0 +1,164 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include "PlatformServices.hpp"
+
+using namespace My;
+
+namespace My {
+    static bool ReadSysfsValue(const char* path, char* buffer, size_t size)
+    {
+        FILE* fp = fopen(path, "r");
+        if (!fp) return false;
+
+        bool ok = fgets(buffer, static_cast<int>(size), fp) != nullptr;
+        fclose(fp);
+        return ok;
+    }
+
+    static bool ReadSysfsInteger(const char* path, uint32_t& value)
+    {
+        char buffer[64];
+        if (!ReadSysfsValue(path, buffer, sizeof(buffer))) return false;
+
+        value = static_cast<uint32_t>(strtoul(buffer, nullptr, 10));
+        return true;
+    }
+
+    // cache sizes are reported like "32K" or "8192K"
+    static uint32_t ParseCacheSize(const char* text)
+    {
+        char* end;
+        unsigned long size = strtoul(text, &end, 10);
+        if (*end == 'K') size *= 1024;
+        else if (*end == 'M') size *= 1024 * 1024;
+        return static_cast<uint32_t>(size);
+    }
+}
+
+uint64_t My::GetMonotonicTime()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+void My::QueryCpuTopology(CpuTopology& topology)
+{
+    topology.processors.clear();
+    topology.cacheLineSize = 64;
+    topology.l1DataCacheSize = 0;
+    topology.l2CacheSize = 0;
+    topology.l3CacheSize = 0;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long i = 0; i < online && i < CPU_SETSIZE; i++) CPU_SET(i, &set);
+    }
+
+    char path[128];
+    for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &set)) continue;
+
+        LogicalProcessor lp;
+        lp.id = cpu;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_id", cpu);
+        if (!ReadSysfsInteger(path, lp.coreId)) lp.coreId = cpu;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu);
+        if (!ReadSysfsInteger(path, lp.packageId)) lp.packageId = 0;
+
+        topology.processors.push_back(lp);
+    }
+
+    // a core is a distinct (package, core) pair
+    std::vector<uint64_t> cores;
+    std::vector<uint32_t> packages;
+    for (const LogicalProcessor& lp : topology.processors) {
+        cores.push_back((static_cast<uint64_t>(lp.packageId) << 32) | lp.coreId);
+        packages.push_back(lp.packageId);
+    }
+    std::sort(cores.begin(), cores.end());
+    std::sort(packages.begin(), packages.end());
+
+    topology.logicalProcessorCount = static_cast<uint32_t>(topology.processors.size());
+    topology.physicalCoreCount = static_cast<uint32_t>(std::unique(cores.begin(), cores.end()) - cores.begin());
+    topology.packageCount = static_cast<uint32_t>(std::unique(packages.begin(), packages.end()) - packages.begin());
+
+    if (topology.processors.empty()) return;
+
+    uint32_t cpu = topology.processors[0].id;
+    for (uint32_t index = 0; ; index++) {
+        char value[64];
+        uint32_t level;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/level", cpu, index);
+        if (!ReadSysfsInteger(path, level)) break;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/type", cpu, index);
+        if (!ReadSysfsValue(path, value, sizeof(value))) continue;
+        if (strncmp(value, "Instruction", 11) == 0) continue;
+
+        uint32_t lineSize;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/coherency_line_size", cpu, index);
+        if (level == 1 && ReadSysfsInteger(path, lineSize) && lineSize) topology.cacheLineSize = lineSize;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/size", cpu, index);
+        if (!ReadSysfsValue(path, value, sizeof(value))) continue;
+
+        uint32_t size = ParseCacheSize(value);
+        if (level == 1) topology.l1DataCacheSize = size;
+        else if (level == 2) topology.l2CacheSize = size;
+        else if (level == 3) topology.l3CacheSize = size;
+    }
+}
+
+bool My::SetCurrentThreadName(const char* name)
+{
+    // the kernel limit is 16 bytes including the terminator
+    char truncated[16];
+    strncpy(truncated, name, sizeof(truncated) - 1);
+    truncated[sizeof(truncated) - 1] = '\0';
+
+    return pthread_setname_np(pthread_self(), truncated) == 0;
+}
+
+bool My::SetCurrentThreadAffinity(const uint32_t* cpus, uint32_t count)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (uint32_t i = 0; i < count; i++) {
+        if (cpus[i] < CPU_SETSIZE) CPU_SET(cpus[i], &set);
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool My::SetCurrentThreadPriority(ThreadPriority priority)
+{
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+
+    if (priority == kThreadPriorityRealtime) {
+        param.sched_priority = sched_get_priority_min(SCHED_RR) + 1;
+        return pthread_setschedparam(pthread_self(), SCHED_RR, &param) == 0;
+    }
+
+    if (pthread_setschedparam(pthread_self(), SCHED_OTHER, &param) != 0) return false;
+
+    // within SCHED_OTHER the nice value is per thread on Linux; raising it
+    // above normal needs CAP_SYS_NICE or a suitable RLIMIT_NICE
+    static const int kNiceValues[] = { 10, 0, -10 };
+    pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    return setpriority(PRIO_PROCESS, tid, kNiceValues[priority]) == 0;
+}
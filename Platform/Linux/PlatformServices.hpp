@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace My {
+    typedef enum ThreadPriority {
+        kThreadPriorityLow = 0,      ///< background work, yields to everything else
+        kThreadPriorityNormal,
+        kThreadPriorityHigh,         ///< main/render threads
+        kThreadPriorityRealtime,     ///< round-robin real-time class, needs privileges
+    } ThreadPriority;
+
+    struct LogicalProcessor {
+        uint32_t id;        ///< OS cpu number, as used for affinity
+        uint32_t coreId;    ///< physical core within the package
+        uint32_t packageId; ///< socket
+    };
+
+    struct CpuTopology {
+        uint32_t logicalProcessorCount;
+        uint32_t physicalCoreCount;
+        uint32_t packageCount;
+        uint32_t cacheLineSize;     ///< bytes
+        uint32_t l1DataCacheSize;   ///< bytes, 0 if unknown
+        uint32_t l2CacheSize;       ///< bytes, 0 if unknown
+        uint32_t l3CacheSize;       ///< bytes, 0 if unknown
+        std::vector<LogicalProcessor> processors; ///< usable by this process
+    };
+
+    /// Monotonic time in nanoseconds, unaffected by wall clock changes.
+    uint64_t GetMonotonicTime();
+
+    /// Queries the processors this process may run on. Never fails; falls
+    /// back to one core per logical processor when sysfs is unavailable.
+    void QueryCpuTopology(CpuTopology& topology);
+
+    /// Names the calling thread for debuggers and profilers (15 chars max).
+    bool SetCurrentThreadName(const char* name);
+
+    /// Restricts the calling thread to the given logical processors.
+    bool SetCurrentThreadAffinity(const uint32_t* cpus, uint32_t count);
+
+    /// Best effort: returns false if the OS refused (e.g. missing privileges),
+    /// the thread then keeps its previous priority.
+    bool SetCurrentThreadPriority(ThreadPriority priority);
+}
@@ -1,6 +1,9 @@
 #include "WindowsApplication.hpp"
 #include "D3d/D3d12GraphicsManager.hpp"
 #include "MemoryManager.hpp"
+#include "Profiler.hpp"
+#include "Logger.hpp"
+#include "EventBus.hpp"
 #include <tchar.h>
 
 using namespace My;
@@ -10,5 +13,8 @@ namespace My {
 	IApplication* g_pApp                = static_cast<IApplication*>(new WindowsApplication(config));
     GraphicsManager* g_pGraphicsManager = static_cast<GraphicsManager*>(new D3d12GraphicsManager);
     MemoryManager*   g_pMemoryManager   = static_cast<MemoryManager*>(new MemoryManager);
+    Profiler*        g_pProfiler        = static_cast<Profiler*>(new Profiler);
+    Logger*          g_pLogger          = static_cast<Logger*>(new Logger);
+    EventBus*        g_pEventBus        = static_cast<EventBus*>(new EventBus);
 
 }
\ No newline at end of file
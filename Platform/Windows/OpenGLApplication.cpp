@@ -1,8 +1,10 @@
-#include <stdio.h>
 #include <tchar.h>
 #include "OpenGLApplication.hpp"
 #include "OpenGL/OpenGLGraphicsManager.hpp"
 #include "MemoryManager.hpp"
+#include "Profiler.hpp"
+#include "Logger.hpp"
+#include "EventBus.hpp"
 #include "glad/glad_wgl.h"
 
 using namespace My;
@@ -12,6 +14,9 @@ namespace My {
 	IApplication* g_pApp                = static_cast<IApplication*>(new OpenGLApplication(config));
     GraphicsManager* g_pGraphicsManager = static_cast<GraphicsManager*>(new OpenGLGraphicsManager);
     MemoryManager*   g_pMemoryManager   = static_cast<MemoryManager*>(new MemoryManager);
+    Profiler*        g_pProfiler        = static_cast<Profiler*>(new Profiler);
+    Logger*          g_pLogger          = static_cast<Logger*>(new Logger);
+    EventBus*        g_pEventBus        = static_cast<EventBus*>(new EventBus);
 
 }
 
@@ -20,7 +25,7 @@ int My::OpenGLApplication::Initialize()
     int result;
     result = WindowsApplication::Initialize();
     if (result) {
-        printf("Windows Application initialize failed!");
+        LOG_ERROR("Windows Application initialize failed!");
     } else {
         PIXELFORMATDESCRIPTOR pfd;
         memset(&pfd, 0, sizeof(PIXELFORMATDESCRIPTOR));
@@ -59,11 +64,11 @@ int My::OpenGLApplication::Initialize()
         }
 
         if (!gladLoadWGL(hDC)) {
-            printf("WGL initialize failed!\n");
+            LOG_ERROR("WGL initialize failed!");
             result = -1;
         } else {
             result = 0;
-            printf("WGL initialize finished!\n");
+            LOG_INFO("WGL initialize finished!");
         }
     }
 
@@ -83,5 +88,6 @@ void My::OpenGLApplication::Finalize()
 
 void My::OpenGLApplication::Tick()
 {
+    PROFILE_SCOPE("OpenGLApplication::Tick");
     WindowsApplication::Tick();
 }
\ No newline at end of file
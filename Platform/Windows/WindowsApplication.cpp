@@ -1,5 +1,6 @@
 #include <tchar.h>
 #include "WindowsApplication.hpp"
+#include "Profiler.hpp"
 
 using namespace My;
 
@@ -55,6 +56,7 @@ void My::WindowsApplication::Finalize() {
 }
 
 void My::WindowsApplication::Tick() {
+	PROFILE_SCOPE("WindowsApplication::Tick");
 	MSG msg;
 	if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
 		TranslateMessage(&msg);
@@ -2,6 +2,7 @@
 #include <d3dcompiler.h>
 #include "D3d12GraphicsManager.hpp"
 #include "WindowsApplication.hpp"
+#include "Profiler.hpp"
 
 using namespace My;
 
@@ -186,6 +187,7 @@ int  My::D3d12GraphicsManager::Initialize()
 
 void My::D3d12GraphicsManager::Tick()
 {
+    PROFILE_SCOPE("D3d12GraphicsManager::Tick");
 }
 
 void My::D3d12GraphicsManager::Finalize()
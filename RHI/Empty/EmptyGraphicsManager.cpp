@@ -0,0 +1,116 @@
+#include <string.h>
+#include "EmptyGraphicsManager.hpp"
+#include "MemoryManager.hpp"
+#include "Profiler.hpp"
+#include "geommath.hpp"
+
+using namespace My;
+
+namespace My {
+    extern MemoryManager* g_pMemoryManager;
+
+    struct EmptyGraphicsManager::SyntheticObject {
+        Vector3f position;
+        Vector3f rotation;
+        Vector3f extent;
+    };
+
+    struct SyntheticDrawRecord {
+        float    mvp[16];   ///< pool blocks are only 4-byte aligned
+        uint32_t objectIndex;
+    };
+}
+
+int My::EmptyGraphicsManager::Initialize()
+{
+    int result = GraphicsManager::Initialize();
+
+    m_pObjects = new SyntheticObject[m_nObjectCount];
+
+    // deterministic layout so every run does the same amount of work
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < m_nObjectCount; i++) {
+        float v[9];
+        for (int j = 0; j < 9; j++) {
+            seed = seed * 1664525u + 1013904223u;
+            v[j] = (seed >> 8) * (1.0f / 16777216.0f);
+        }
+        m_pObjects[i].position = Vector3f(v[0] * 200.0f - 100.0f, v[1] * 20.0f, v[2] * 200.0f - 100.0f);
+        m_pObjects[i].rotation = Vector3f(v[3] * TWO_PI, v[4] * TWO_PI, v[5] * TWO_PI);
+        m_pObjects[i].extent   = Vector3f(0.5f + v[6], 0.5f + v[7], 0.5f + v[8]);
+    }
+
+    m_nFrame = 0;
+    m_nChecksum = 0.0f;
+
+    return result;
+}
+
+void My::EmptyGraphicsManager::Finalize()
+{
+    delete[] m_pObjects;
+    m_pObjects = nullptr;
+
+    GraphicsManager::Finalize();
+}
+
+void My::EmptyGraphicsManager::Tick()
+{
+    PROFILE_SCOPE("EmptyGraphicsManager::Tick");
+
+    // fixed field of view, so the projection folds to a constant
+    static constexpr Matrix4X4f kProjection = PerspectiveFovLHMatrix(PI / 4.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+    Matrix4X4f view, viewProjection;
+    float angle = m_nFrame * 0.01f;
+    Vector3f eye(150.0f * cosf(angle), 50.0f, 150.0f * sinf(angle));
+    Vector3f lookAt(0.0f, 0.0f, 0.0f);
+    Vector3f up(0.0f, 1.0f, 0.0f);
+    BuildViewMatrix(view, eye, lookAt, up);
+    MatrixMultiply(viewProjection, view, kProjection);
+
+    SyntheticDrawRecord** records = static_cast<SyntheticDrawRecord**>(
+        g_pMemoryManager->Allocate(sizeof(SyntheticDrawRecord*) * m_nObjectCount));
+
+    float checksum = 0.0f;
+    for (uint32_t i = 0; i < m_nObjectCount; i++) {
+        const SyntheticObject& obj = m_pObjects[i];
+
+        Matrix3X3f rotation;
+        Matrix4X4f world, translation, rotation4;
+        MatrixRotationYawPitchRoll(rotation, obj.rotation.y + angle, obj.rotation.x, obj.rotation.z);
+        BuildIdentityMatrix(rotation4);
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                rotation4[r][c] = rotation[r][c];
+            }
+        }
+        MatrixTranslation(translation, obj.position.x, obj.position.y, obj.position.z);
+        MatrixMultiply(world, rotation4, translation);
+
+        // rotate the corners of the local bounds as a culling pass would
+        for (int corner = 0; corner < 8; corner++) {
+            Vector3f v(
+                (corner & 1) ? obj.extent.x : -obj.extent.x,
+                (corner & 2) ? obj.extent.y : -obj.extent.y,
+                (corner & 4) ? obj.extent.z : -obj.extent.z);
+            TransformCoord(v, rotation);
+            checksum += v.x + v.y + v.z;
+        }
+
+        records[i] = static_cast<SyntheticDrawRecord*>(g_pMemoryManager->Allocate(sizeof(SyntheticDrawRecord)));
+        Matrix4X4f mvp;
+        MatrixMultiply(mvp, world, viewProjection);
+        memcpy(records[i]->mvp, mvp.flat, sizeof(records[i]->mvp));
+        records[i]->objectIndex = i;
+    }
+
+    for (uint32_t i = 0; i < m_nObjectCount; i++) {
+        checksum += records[i]->mvp[15];
+        g_pMemoryManager->Free(records[i], sizeof(SyntheticDrawRecord));
+    }
+    g_pMemoryManager->Free(records, sizeof(SyntheticDrawRecord*) * m_nObjectCount);
+
+    m_nChecksum += checksum;
+    ++m_nFrame;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+#include "GraphicsManager.hpp"
+
+namespace My {
+    /// Graphics manager without a device. Tick() runs a fixed synthetic
+    /// CPU workload shaped like a frame's render preparation (per-object
+    /// matrices, bounds transform, draw record allocation) so the headless
+    /// Empty build gives reproducible frame timings.
+    class EmptyGraphicsManager : public GraphicsManager
+    {
+    public:
+        EmptyGraphicsManager(uint32_t objectCount = 4096)
+            : m_nObjectCount(objectCount), m_nFrame(0), m_pObjects(nullptr), m_nChecksum(0) {};
+
+        virtual int Initialize();
+        virtual void Finalize();
+
+        virtual void Tick();
+
+        /// Folded result of the workload, keeps the optimizer honest.
+        inline float GetChecksum() const { return m_nChecksum; };
+
+    private:
+        struct SyntheticObject;
+
+        uint32_t         m_nObjectCount;
+        uint32_t         m_nFrame;
+        SyntheticObject* m_pObjects;
+        float            m_nChecksum;
+    };
+}
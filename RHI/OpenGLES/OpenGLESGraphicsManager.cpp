@@ -1,6 +1,7 @@
-#include <stdio.h>
 #include "glad/glad_egl.h"
 #include "OpenGLESGraphicsManager.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
 
 using namespace My;
 
@@ -12,11 +13,11 @@ int My::OpenGLESGraphicsManager::Initialize()
 
     result = gladLoadGL();
     if (!result) {
-        printf("OpenGL load failed!\n");
+        LOG_ERROR("OpenGL load failed!");
         result = -1;
     } else {
         result = 0;
-        printf("OpenGL Version %d.%d loaded\n", GLVersion.major, GLVersion.minor);
+        LOG_INFO("OpenGL Version %d.%d loaded", GLVersion.major, GLVersion.minor);
 
         if (GLAD_GL_VERSION_3_0) {
             // Set the depth buffer to be entirely cleared to 1.0 values.
@@ -43,4 +44,5 @@ void My::OpenGLESGraphicsManager::Finalize()
 
 void My::OpenGLESGraphicsManager::Tick()
 {
+    PROFILE_SCOPE("OpenGLESGraphicsManager::Tick");
 }